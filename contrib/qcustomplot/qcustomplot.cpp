@@ -14416,6 +14416,154 @@ QCPData::QCPData(double key, double value) :
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPDataMap
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  inline bool qcpDataKeyLess(const QCPData &data, double key) { return data.key < key; }
+  inline bool qcpKeyDataLess(double key, const QCPData &data) { return key < data.key; }
+  inline bool qcpDataLess(const QCPData &a, const QCPData &b) { return a.key < b.key; }
+}
+
+/*!
+  Returns an iterator to the first data point with a key equal to or greater than \a key, or end()
+  if there is no such point. This is a binary search, equivalent to QMap::lowerBound.
+*/
+QCPDataMap::iterator QCPDataMap::lowerBound(double key)
+{
+  return iterator(std::lower_bound(mData.data(), mData.data()+mData.size(), key, qcpDataKeyLess));
+}
+
+/*!
+  Returns an iterator to the first data point with a key greater than \a key, or end() if there is
+  no such point. This is a binary search, equivalent to QMap::upperBound.
+*/
+QCPDataMap::iterator QCPDataMap::upperBound(double key)
+{
+  return iterator(std::upper_bound(mData.data(), mData.data()+mData.size(), key, qcpKeyDataLess));
+}
+
+/*! \overload
+*/
+QCPDataMap::const_iterator QCPDataMap::lowerBound(double key) const
+{
+  return const_iterator(std::lower_bound(mData.constData(), mData.constData()+mData.size(), key, qcpDataKeyLess));
+}
+
+/*! \overload
+*/
+QCPDataMap::const_iterator QCPDataMap::upperBound(double key) const
+{
+  return const_iterator(std::upper_bound(mData.constData(), mData.constData()+mData.size(), key, qcpKeyDataLess));
+}
+
+/*!
+  Returns the number of data points with keys in the closed interval [\a lowerKey, \a upperKey],
+  using two binary searches.
+*/
+int QCPDataMap::countInRange(double lowerKey, double upperKey) const
+{
+  if (lowerKey > upperKey) return 0;
+  return int(upperBound(upperKey) - lowerBound(lowerKey));
+}
+
+/*!
+  Inserts \a data at \a key. If there already is a data point with this key, its value is replaced
+  (like QMap::insert). Use \ref insertMulti to keep existing points with the same key.
+*/
+QCPDataMap::iterator QCPDataMap::insert(double key, const QCPData &data)
+{
+  iterator it = lowerBound(key);
+  if (it != end() && it.key() == key)
+  {
+    *it = data;
+    it->key = key;
+    return it;
+  }
+  return insertMulti(key, data);
+}
+
+/*!
+  Inserts \a data at \a key, after any existing data points with the same key.
+  
+  Appending data in increasing key order, which is how graphs are typically filled, is an amortized
+  constant time operation. Inserting elsewhere requires moving the subsequent data points.
+*/
+QCPDataMap::iterator QCPDataMap::insertMulti(double key, const QCPData &data)
+{
+  if (mData.isEmpty() || !(key < mData.last().key))
+  {
+    // fast path: append
+    mData.append(data);
+    mData.last().key = key;
+    return iterator(mData.data()+mData.size()-1);
+  }
+  int index = int(upperBound(key) - begin());
+  mData.insert(index, data);
+  mData[index].key = key;
+  return iterator(mData.data()+index);
+}
+
+/*!
+  Adds all data points of \a other to this map. If all keys of \a other lie after the last key in
+  this map, the points are appended, otherwise both sorted sequences are merged in linear time.
+*/
+QCPDataMap &QCPDataMap::unite(const QCPDataMap &other)
+{
+  if (other.isEmpty())
+    return *this;
+  if (mData.isEmpty() || !(other.mData.first().key < mData.last().key))
+  {
+    mData += other.mData;
+  } else
+  {
+    QVector<QCPData> merged(mData.size()+other.mData.size());
+    std::merge(mData.constBegin(), mData.constEnd(), other.mData.constBegin(), other.mData.constEnd(), merged.begin(), qcpDataLess);
+    mData.swap(merged);
+  }
+  return *this;
+}
+
+/*!
+  Removes the data point at \a it and returns an iterator to the next data point.
+  
+  To remove a range of data points, use \ref erase(iterator first, iterator last), which moves the
+  remaining data only once.
+*/
+QCPDataMap::iterator QCPDataMap::erase(iterator it)
+{
+  return erase(it, it+1);
+}
+
+/*! \overload
+  
+  Removes the data points in the range [\a first, \a last) and returns an iterator to the data point
+  that followed the removed range.
+*/
+QCPDataMap::iterator QCPDataMap::erase(iterator first, iterator last)
+{
+  int index = int(first - begin());
+  int n = int(last - first);
+  if (n > 0)
+    mData.remove(index, n);
+  return iterator(mData.data()+index);
+}
+
+/*!
+  Removes all data points with the given \a key and returns the number of removed points.
+*/
+int QCPDataMap::remove(double key)
+{
+  iterator first = lowerBound(key);
+  iterator last = upperBound(key);
+  int n = int(last - first);
+  erase(first, last);
+  return n;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPGraph
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -14542,6 +14690,7 @@ void QCPGraph::setData(const QVector<double> &key, const QVector<double> &value)
   mData->clear();
   int n = key.size();
   n = qMin(n, value.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14566,6 +14715,7 @@ void QCPGraph::setDataValueError(const QVector<double> &key, const QVector<doubl
   int n = key.size();
   n = qMin(n, value.size());
   n = qMin(n, valueError.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14593,6 +14743,7 @@ void QCPGraph::setDataValueError(const QVector<double> &key, const QVector<doubl
   n = qMin(n, value.size());
   n = qMin(n, valueErrorMinus.size());
   n = qMin(n, valueErrorPlus.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14619,6 +14770,7 @@ void QCPGraph::setDataKeyError(const QVector<double> &key, const QVector<double>
   int n = key.size();
   n = qMin(n, value.size());
   n = qMin(n, keyError.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14646,6 +14798,7 @@ void QCPGraph::setDataKeyError(const QVector<double> &key, const QVector<double>
   n = qMin(n, value.size());
   n = qMin(n, keyErrorMinus.size());
   n = qMin(n, keyErrorPlus.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14673,6 +14826,7 @@ void QCPGraph::setDataBothError(const QVector<double> &key, const QVector<double
   n = qMin(n, value.size());
   n = qMin(n, valueError.size());
   n = qMin(n, keyError.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14704,6 +14858,7 @@ void QCPGraph::setDataBothError(const QVector<double> &key, const QVector<double
   n = qMin(n, valueErrorPlus.size());
   n = qMin(n, keyErrorMinus.size());
   n = qMin(n, keyErrorPlus.size());
+  mData->reserve(n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14904,6 +15059,7 @@ void QCPGraph::addData(double key, double value)
 void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &values)
 {
   int n = qMin(keys.size(), values.size());
+  mData->reserve(mData->size()+n);
   QCPData newData;
   for (int i=0; i<n; ++i)
   {
@@ -14919,9 +15075,7 @@ void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &value
 */
 void QCPGraph::removeDataBefore(double key)
 {
-  QCPDataMap::iterator it = mData->begin();
-  while (it != mData->end() && it.key() < key)
-    it = mData->erase(it);
+  mData->erase(mData->begin(), mData->lowerBound(key));
 }
 
 /*!
@@ -14931,9 +15085,7 @@ void QCPGraph::removeDataBefore(double key)
 void QCPGraph::removeDataAfter(double key)
 {
   if (mData->isEmpty()) return;
-  QCPDataMap::iterator it = mData->upperBound(key);
-  while (it != mData->end())
-    it = mData->erase(it);
+  mData->erase(mData->upperBound(key), mData->end());
 }
 
 /*!
@@ -14946,10 +15098,7 @@ void QCPGraph::removeDataAfter(double key)
 void QCPGraph::removeData(double fromKey, double toKey)
 {
   if (fromKey >= toKey || mData->isEmpty()) return;
-  QCPDataMap::iterator it = mData->upperBound(fromKey);
-  QCPDataMap::iterator itEnd = mData->upperBound(toKey);
-  while (it != itEnd)
-    it = mData->erase(it);
+  mData->erase(mData->upperBound(fromKey), mData->upperBound(toKey));
 }
 
 /*! \overload
@@ -15991,14 +16140,8 @@ int QCPGraph::countDataInBounds(const QCPDataMap::const_iterator &lower, const Q
 {
   if (upper == mData->constEnd() && lower == mData->constEnd())
     return 0;
-  QCPDataMap::const_iterator it = lower;
-  int count = 1;
-  while (it != upper && count < maxCount)
-  {
-    ++it;
-    ++count;
-  }
-  return count;
+  // QCPDataMap is contiguous, so the count follows directly from the iterator distance
+  return qMin(int(upper-lower)+1, maxCount);
 }
 
 /*! \internal
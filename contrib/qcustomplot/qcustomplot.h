@@ -45,6 +45,8 @@
 #include <QMargins>
 #include <qmath.h>
 #include <limits>
+#include <algorithm>
+#include <iterator>
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
 #  include <qnumeric.h>
 #  include <QPrinter>
@@ -2475,16 +2477,126 @@ public:
 };
 Q_DECLARE_TYPEINFO(QCPData, Q_MOVABLE_TYPE);
 
-/*! \typedef QCPDataMap
+/*! \class QCPDataMap
   Container for storing \ref QCPData items in a sorted fashion. The key of the map
   is the key member of the QCPData instance.
   
+  The data is kept in a contiguous, key-sorted vector instead of a tree. It offers the subset of
+  the QMap interface that is used with QCPGraph (iterators with key() and value(), insertMulti,
+  lowerBound, upperBound, erase, remove, unite), but inserting data with increasing keys is an
+  amortized constant time append, and the iterators are random access, so the number of points in
+  a key range can be determined without walking the data.
+  
   This is the container in which QCPGraph holds its data.
   \see QCPData, QCPGraph::setData
 */
-typedef QMap<double, QCPData> QCPDataMap;
-typedef QMapIterator<double, QCPData> QCPDataMapIterator;
-typedef QMutableMapIterator<double, QCPData> QCPDataMutableMapIterator;
+class QCP_LIB_DECL QCPDataMap
+{
+public:
+  template <class T, class P>
+  class Iterator
+  {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef T *pointer;
+    typedef T &reference;
+    
+    Iterator() : mPtr(0) {}
+    explicit Iterator(P ptr) : mPtr(ptr) {}
+    template <class T2, class P2> Iterator(const Iterator<T2, P2> &other) : mPtr(other.ptr()) {}
+    
+    double key() const { return mPtr->key; }
+    T &value() const { return *mPtr; }
+    T &operator*() const { return *mPtr; }
+    T *operator->() const { return mPtr; }
+    T &operator[](difference_type n) const { return mPtr[n]; }
+    P ptr() const { return mPtr; }
+    
+    Iterator &operator++() { ++mPtr; return *this; }
+    Iterator operator++(int) { Iterator result(*this); ++mPtr; return result; }
+    Iterator &operator--() { --mPtr; return *this; }
+    Iterator operator--(int) { Iterator result(*this); --mPtr; return result; }
+    Iterator &operator+=(difference_type n) { mPtr += n; return *this; }
+    Iterator &operator-=(difference_type n) { mPtr -= n; return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(mPtr+n); }
+    Iterator operator-(difference_type n) const { return Iterator(mPtr-n); }
+    template <class T2, class P2> difference_type operator-(const Iterator<T2, P2> &other) const { return mPtr-other.ptr(); }
+    
+    template <class T2, class P2> bool operator==(const Iterator<T2, P2> &other) const { return mPtr == other.ptr(); }
+    template <class T2, class P2> bool operator!=(const Iterator<T2, P2> &other) const { return mPtr != other.ptr(); }
+    template <class T2, class P2> bool operator<(const Iterator<T2, P2> &other) const { return mPtr < other.ptr(); }
+    template <class T2, class P2> bool operator>(const Iterator<T2, P2> &other) const { return mPtr > other.ptr(); }
+    template <class T2, class P2> bool operator<=(const Iterator<T2, P2> &other) const { return mPtr <= other.ptr(); }
+    template <class T2, class P2> bool operator>=(const Iterator<T2, P2> &other) const { return mPtr >= other.ptr(); }
+    
+  private:
+    P mPtr;
+  };
+  typedef Iterator<QCPData, QCPData*> iterator;
+  typedef Iterator<const QCPData, const QCPData*> const_iterator;
+  typedef double key_type;
+  typedef QCPData mapped_type;
+  typedef int size_type;
+  
+  QCPDataMap() {}
+  
+  // getters:
+  int size() const { return mData.size(); }
+  int count() const { return mData.size(); }
+  bool isEmpty() const { return mData.isEmpty(); }
+  bool empty() const { return mData.isEmpty(); }
+  const QVector<QCPData> &vector() const { return mData; }
+  
+  iterator begin() { return iterator(mData.data()); }
+  iterator end() { return iterator(mData.data()+mData.size()); }
+  const_iterator begin() const { return const_iterator(mData.constData()); }
+  const_iterator end() const { return const_iterator(mData.constData()+mData.size()); }
+  const_iterator constBegin() const { return begin(); }
+  const_iterator constEnd() const { return end(); }
+  
+  iterator lowerBound(double key);
+  iterator upperBound(double key);
+  const_iterator lowerBound(double key) const;
+  const_iterator upperBound(double key) const;
+  int countInRange(double lowerKey, double upperKey) const;
+  
+  // non-property methods:
+  void clear() { mData.clear(); }
+  void reserve(int size) { mData.reserve(size); }
+  void squeeze() { mData.squeeze(); }
+  iterator insert(double key, const QCPData &data);
+  iterator insertMulti(double key, const QCPData &data);
+  QCPDataMap &unite(const QCPDataMap &other);
+  iterator erase(iterator it);
+  iterator erase(iterator first, iterator last);
+  int remove(double key);
+  
+private:
+  QVector<QCPData> mData;
+};
+
+/*! \class QCPDataMapIterator
+  Java-style read-only iterator for \ref QCPDataMap, with the same interface as QMapIterator.
+*/
+class QCP_LIB_DECL QCPDataMapIterator
+{
+public:
+  QCPDataMapIterator(const QCPDataMap &map) : mMap(&map), mIt(map.constBegin()), mLast(map.constEnd()) {}
+  bool hasNext() const { return mIt != mMap->constEnd(); }
+  bool hasPrevious() const { return mIt != mMap->constBegin(); }
+  const QCPDataMapIterator &next() { mLast = mIt++; return *this; }
+  const QCPDataMapIterator &previous() { mLast = --mIt; return *this; }
+  void toFront() { mIt = mMap->constBegin(); mLast = mMap->constEnd(); }
+  void toBack() { mIt = mMap->constEnd(); mLast = mMap->constEnd(); }
+  double key() const { return mLast.key(); }
+  const QCPData &value() const { return mLast.value(); }
+  
+protected:
+  const QCPDataMap *mMap;
+  QCPDataMap::const_iterator mIt, mLast;
+};
 
 
 class QCP_LIB_DECL QCPGraph : public QCPAbstractPlottable
@@ -0,0 +1,147 @@
+/*
+** AsyncLogSink.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "AsyncLogSink.h"
+
+#include "xo/system/log.h"
+#include "xo/string/string_tools.h"
+
+namespace scone
+{
+	// interval at which the writer thread flushes the queue
+	constexpr auto writer_interval = std::chrono::milliseconds( 50 );
+
+	// interval at which repeats of a message that keeps being logged are reported
+	constexpr auto repeat_report_interval = std::chrono::seconds( 1 );
+
+	AsyncLogSink::AsyncLogSink( xo::log::sink& target, xo::log::level l, bool writer_thread, int max_messages_per_second ) :
+		xo::log::sink( l, xo::log::sink_mode::all_threads ),
+		target_( target ),
+		join_lines_( !writer_thread ),
+		max_messages_per_second_( max_messages_per_second ),
+		head_( new Node{ l, String(), nullptr } ),
+		rate_window_( 0 ),
+		rate_count_( 0 ),
+		dropped_count_( 0 ),
+		last_level_( l ),
+		repeat_count_( 0 ),
+		stop_( false )
+	{
+		tail_ = head_.load();
+		if ( writer_thread )
+			thread_ = std::thread( &AsyncLogSink::threadFunc, this );
+		xo::log::add_sink( this );
+	}
+
+	AsyncLogSink::~AsyncLogSink()
+	{
+		xo::log::remove_sink( this );
+		stop_ = true;
+		if ( thread_.joinable() )
+			thread_.join();
+
+		// forward everything that is left, including pending repeats
+		flush();
+		forwardRepeats();
+		submitBatch();
+		delete tail_;
+	}
+
+	void AsyncLogSink::submit_msg( xo::log::level l, const std::string& msg )
+	{
+		// errors are never dropped
+		auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+		auto window = rate_window_.load( std::memory_order_relaxed );
+		if ( now_ms - window >= 1000 && rate_window_.compare_exchange_strong( window, now_ms ) )
+			rate_count_ = 0;
+		if ( ++rate_count_ > max_messages_per_second_ && l < xo::log::level::error ) {
+			++dropped_count_;
+			return;
+		}
+
+		auto* n = new Node{ l, msg, nullptr };
+		auto* prev = head_.exchange( n, std::memory_order_acq_rel );
+		prev->next.store( n, std::memory_order_release );
+	}
+
+	void AsyncLogSink::flush()
+	{
+		auto now = std::chrono::steady_clock::now();
+		xo::log::level l;
+		String msg;
+		while ( pop( l, msg ) )
+		{
+			if ( l == last_level_ && msg == last_msg_ ) {
+				if ( repeat_count_++ == 0 )
+					repeat_start_ = now;
+				continue;
+			}
+			forwardRepeats();
+			last_level_ = l;
+			last_msg_ = msg;
+			forward( l, std::move( msg ) );
+		}
+
+		// messages that keep being repeated are reported periodically
+		if ( repeat_count_ > 0 && now - repeat_start_ >= repeat_report_interval )
+			forwardRepeats();
+
+		if ( auto dropped = dropped_count_.exchange( 0 ); dropped > 0 )
+			forward( xo::log::level::warning, xo::stringf( "%d log messages were dropped", dropped ) );
+
+		submitBatch();
+	}
+
+	bool AsyncLogSink::pop( xo::log::level& l, String& msg )
+	{
+		// tail_ is a node that has already been consumed, its successor holds the next message
+		auto* next = tail_->next.load( std::memory_order_acquire );
+		if ( !next )
+			return false;
+		l = next->level;
+		msg = std::move( next->msg );
+		delete tail_;
+		tail_ = next;
+		return true;
+	}
+
+	void AsyncLogSink::forward( xo::log::level l, String msg )
+	{
+		batch_.emplace_back( l, std::move( msg ) );
+	}
+
+	void AsyncLogSink::forwardRepeats()
+	{
+		if ( repeat_count_ > 0 ) {
+			forward( last_level_, xo::stringf( "(last message repeated %d times)", repeat_count_ ) );
+			repeat_count_ = 0;
+		}
+	}
+
+	void AsyncLogSink::submitBatch()
+	{
+		for ( auto it = batch_.begin(); it != batch_.end(); )
+		{
+			auto l = it->first;
+			auto text = std::move( it->second );
+			for ( ++it; join_lines_ && it != batch_.end() && it->first == l; ++it )
+				text += '\n' + it->second;
+			target_.submit_msg( l, text );
+		}
+		batch_.clear();
+	}
+
+	void AsyncLogSink::threadFunc()
+	{
+		while ( !stop_ )
+		{
+			flush();
+			std::this_thread::sleep_for( writer_interval );
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/*
+** AsyncLogSink.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "xo/system/log_sink.h"
+#include "scone/core/types.h"
+
+namespace scone
+{
+	/// Log sink that accepts messages from all threads and forwards them to a target sink in batches.
+	/// Messages are queued without locking, so logging never waits for the target sink.
+	/// With a writer thread, the queue is flushed periodically from that thread (e.g. for files),
+	/// otherwise flush() must be called regularly from a single thread (e.g. for widgets, once per frame).
+	/// Identical consecutive messages are combined, messages exceeding max_messages_per_second are dropped.
+	class AsyncLogSink : public xo::log::sink
+	{
+	public:
+		AsyncLogSink( xo::log::sink& target, xo::log::level l, bool writer_thread, int max_messages_per_second = 500 );
+		virtual ~AsyncLogSink();
+
+		void submit_msg( xo::log::level l, const std::string& msg ) override;
+
+		/// forward queued messages to the target sink, must be called from a single thread
+		/// without writer thread, consecutive messages of the same level are combined into a single submit
+		void flush();
+
+	private:
+		struct Node {
+			xo::log::level level;
+			String msg;
+			std::atomic<Node*> next;
+		};
+		bool pop( xo::log::level& l, String& msg );
+		void forward( xo::log::level l, String msg );
+		void forwardRepeats();
+		void submitBatch();
+		void threadFunc();
+
+		xo::log::sink& target_;
+		bool join_lines_;
+		int max_messages_per_second_;
+
+		// multi-producer single-consumer queue, producers push at head_, the consumer pops after tail_
+		std::atomic<Node*> head_;
+		Node* tail_;
+
+		// rate limiting, window is in milliseconds since the steady clock epoch
+		std::atomic<long long> rate_window_;
+		std::atomic<int> rate_count_;
+		std::atomic<int> dropped_count_;
+
+		// consumer state
+		xo::log::level last_level_;
+		String last_msg_;
+		int repeat_count_;
+		std::chrono::steady_clock::time_point repeat_start_;
+		std::vector< std::pair< xo::log::level, String > > batch_;
+
+		std::atomic<bool> stop_;
+		std::thread thread_;
+	};
+}
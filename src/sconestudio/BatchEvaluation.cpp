@@ -0,0 +1,170 @@
+/*
+** BatchEvaluation.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "BatchEvaluation.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <sstream>
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+#include "scone/core/Factories.h"
+#include "scone/core/system_tools.h"
+#include "scone/optimization/opt_tools.h"
+#include "scone/optimization/ModelObjective.h"
+#include "scone/optimization/Optimizer.h"
+#include "xo/time/timer.h"
+#include "qt_convert.h"
+
+namespace scone
+{
+	std::pair<OptimizerUP, ModelUP> CreateOptimizerAndModel( const path& file )
+	{
+		std::vector<path> included_files;
+		auto scenario_pn = LoadScenario( file, &included_files );
+		auto opt_fp = TryFindFactoryProps( GetOptimizerFactory(), scenario_pn, "Optimizer" );
+		SCONE_ERROR_IF( !opt_fp, "Could not find Optimizer in " + file.str() );
+		auto optimizer = GetOptimizerFactory().create( opt_fp.type(), opt_fp.props(), scenario_pn, file.parent_path() );
+		auto* mo = dynamic_cast<ModelObjective*>( &optimizer->GetObjective() );
+		SCONE_ERROR_IF( !mo, "Objective does not use a model" );
+
+		if ( file.extension_no_dot() == "par" ) {
+			mo->info().import_mean_std( file, spot::par_import_settings{} );
+			auto model = mo->CreateModelFromParFile( file );
+			return { std::move( optimizer ), std::move( model ) };
+		}
+		else {
+			auto model = mo->CreateModelFromParams( SearchPoint( mo->info() ) );
+			return { std::move( optimizer ), std::move( model ) };
+		}
+	}
+
+	BatchEvaluation::BatchEvaluation( const QStringList& files, bool store_data, QObject* parent ) :
+		QObject( parent ),
+		files_( files ),
+		store_data_( store_data ),
+		results_( files.size() ),
+		next_file_( 0 ),
+		finished_count_( 0 ),
+		cancel_( false )
+	{}
+
+	BatchEvaluation::~BatchEvaluation()
+	{
+		cancel();
+		wait();
+	}
+
+	void BatchEvaluation::start()
+	{
+		if ( !threads_.empty() )
+			return;
+		auto num_threads = std::min<size_t>( std::max( 1u, std::thread::hardware_concurrency() ), files_.size() );
+		for ( size_t i = 0; i < num_threads; ++i )
+			threads_.emplace_back( &BatchEvaluation::threadFunc, this );
+	}
+
+	void BatchEvaluation::cancel()
+	{
+		cancel_ = true;
+	}
+
+	void BatchEvaluation::wait()
+	{
+		for ( auto& t : threads_ )
+			if ( t.joinable() )
+				t.join();
+	}
+
+	void BatchEvaluation::threadFunc()
+	{
+		for ( size_t idx = next_file_++; idx < size_t( files_.size() ); idx = next_file_++ )
+		{
+			// each result is written by a single thread
+			if ( !cancel_ )
+				results_[ idx ] = evaluate( files_[ int( idx ) ] );
+			else {
+				results_[ idx ].file = files_[ int( idx ) ];
+				results_[ idx ].error = "Cancelled";
+			}
+
+			auto finished_count = ++finished_count_;
+			emit fileEvaluated( int( finished_count ), files_.size() );
+			if ( finished_count == size_t( files_.size() ) )
+				emit finished();
+		}
+	}
+
+	BatchEvaluation::Result BatchEvaluation::evaluate( const QString& file )
+	{
+		Result r;
+		r.file = file;
+		try
+		{
+			xo::timer real_time;
+			auto file_path = path_from_qt( file );
+			auto [optimizer, model] = CreateOptimizerAndModel( file_path );
+			auto* mo = dynamic_cast<ModelObjective*>( &optimizer->GetObjective() );
+			model->SetStoreData( store_data_ );
+			mo->AdvanceSimulationTo( *model, model->GetSimulationEndTime() );
+
+			r.fitness = mo->GetResult( *model );
+			r.report = mo->GetReport( *model );
+			r.sim_time = model->GetTime();
+			r.termination_reason = model->GetTerminationReason();
+			if ( auto sim_report = model->GetSimulationReport(); !sim_report.empty() ) {
+				std::ostringstream str;
+				str << sim_report.front().second;
+				r.simulation_report = str.str();
+			}
+			if ( store_data_ )
+				r.results_file = concat_str( model->WriteResults( file_path ), ", " );
+			r.real_time = real_time().secondsd();
+		}
+		catch ( const std::exception& e )
+		{
+			r.error = e.what();
+		}
+		return r;
+	}
+
+	bool BatchEvaluation::writeSummary( const QString& filename ) const
+	{
+		QFile file( filename );
+		if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+			return false;
+		QTextStream str( &file );
+		writeSummary( str );
+		return true;
+	}
+
+	void BatchEvaluation::writeSummary( QTextStream& str ) const
+	{
+		// report items can differ per scenario, use all items in order of appearance
+		std::vector<String> report_keys;
+		for ( const auto& r : results_ )
+			for ( const auto& [key, child] : r.report )
+				if ( std::find( report_keys.begin(), report_keys.end(), key ) == report_keys.end() )
+					report_keys.push_back( key );
+
+		str << "file\tfitness\tsim_time\treal_time\ttermination_reason";
+		for ( const auto& key : report_keys )
+			str << '\t' << to_qt( key );
+		str << "\tsimulation_report\tresults\terror\n";
+
+		auto clean = []( const String& s ) { return to_qt( s ).replace( '\t', ' ' ).replace( '\n', ' ' ); };
+		for ( const auto& r : results_ )
+		{
+			str << r.file << '\t' << r.fitness << '\t' << r.sim_time << '\t' << r.real_time << '\t' << clean( r.termination_reason );
+			for ( const auto& key : report_keys )
+				str << '\t' << ( r.report.has_key( key ) ? clean( r.report.get<String>( key ) ) : QString() );
+			str << '\t' << clean( r.simulation_report ) << '\t' << clean( r.results_file ) << '\t' << clean( r.error ) << '\n';
+		}
+	}
+}
@@ -0,0 +1,84 @@
+/*
+** BatchEvaluation.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include "scone/core/types.h"
+#include "scone/core/PropNode.h"
+#include "scone/model/Model.h"
+#include "scone/optimization/Optimizer.h"
+
+class QTextStream;
+
+namespace scone
+{
+	/// Create optimizer and model for a .scone or .par file, in the same way as StudioModel but without visualization.
+	/// The model uses parameters from the .par file, or the initial parameters from the scenario.
+	std::pair<OptimizerUP, ModelUP> CreateOptimizerAndModel( const path& file );
+
+	/// Evaluates .par files in parallel without visualization, each thread using its own model instance.
+	/// Signals are emitted from worker threads and should be connected using queued connections, before calling start().
+	class BatchEvaluation : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		struct Result {
+			QString file;
+			double fitness = 0.0;
+			double sim_time = 0.0;
+			double real_time = 0.0;
+			String termination_reason;
+			String simulation_report;
+			PropNode report;
+			String results_file;
+			String error;
+		};
+
+		BatchEvaluation( const QStringList& files, bool store_data, QObject* parent = nullptr );
+		virtual ~BatchEvaluation();
+
+		/// start the worker threads
+		void start();
+		void cancel();
+		void wait();
+		bool isFinished() const { return finished_count_ == size_t( files_.size() ); }
+		int finishedCount() const { return int( finished_count_ ); }
+		int fileCount() const { return files_.size(); }
+
+		/// results in the order of the input files, only valid after finished() is emitted
+		const std::vector<Result>& results() const { return results_; }
+
+		/// write results as a tab-separated table with a column for each item in the fitness report
+		bool writeSummary( const QString& filename ) const;
+		void writeSummary( QTextStream& str ) const;
+
+	signals:
+		void fileEvaluated( int finished, int total );
+		void finished();
+
+	private:
+		void threadFunc();
+		Result evaluate( const QString& file );
+
+		QStringList files_;
+		bool store_data_;
+		std::vector<Result> results_;
+		std::vector<std::thread> threads_;
+		std::atomic<size_t> next_file_;
+		std::atomic<size_t> finished_count_;
+		std::atomic<bool> cancel_;
+	};
+}
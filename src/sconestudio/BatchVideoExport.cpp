@@ -0,0 +1,235 @@
+/*
+** BatchVideoExport.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "BatchVideoExport.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <osg/Matrixd>
+#include <osgDB/Registry>
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+#include "scone/core/StorageIo.h"
+#include "scone/core/Angle.h"
+#include "scone/optimization/ModelObjective.h"
+#include "xo/time/timer.h"
+#include "vis-osg/osg_tools.h"
+#include "BatchEvaluation.h"
+#include "OffscreenRenderer.h"
+#include "VideoEncoder.h"
+#include "StudioSettings.h"
+#include "qt_convert.h"
+
+namespace scone
+{
+	const std::pair<const char*, ViewOption> view_option_names[] = {
+		{ "external_forces", ViewOption::ExternalForces },
+		{ "muscles", ViewOption::Muscles },
+		{ "tendons", ViewOption::Tendons },
+		{ "body_geom", ViewOption::BodyGeom },
+		{ "joints", ViewOption::Joints },
+		{ "body_axes", ViewOption::BodyAxes },
+		{ "contact_geom", ViewOption::ContactGeom },
+		{ "ground_plane", ViewOption::GroundPlane },
+		{ "shadows", ViewOption::Shadows },
+		{ "body_com", ViewOption::BodyCom },
+		{ "model_com_heading", ViewOption::ModelComHeading },
+		{ "static_camera", ViewOption::StaticCamera },
+		{ "muscle_activation", ViewOption::MuscleActivation },
+		{ "muscle_force", ViewOption::MuscleForce },
+		{ "muscle_fiber_length", ViewOption::MuscleFiberLength },
+		{ "muscle_radius_fixed", ViewOption::MuscleRadiusFixed },
+		{ "muscle_radius_pcsa", ViewOption::MuscleRadiusPcsa },
+		{ "muscle_radius_pcsa_dynamic", ViewOption::MuscleRadiusPcsaDynamic },
+		{ "auxiliary_geom", ViewOption::AuxiliaryGeom },
+		{ "joint_reaction_forces", ViewOption::JointReactionForces },
+		{ "follow_camera", ViewOption::FollowCamera },
+		{ "tracking_camera", ViewOption::TrackingCamera }
+	};
+
+	VideoPreset MakeVideoPreset( const PropNode& pn )
+	{
+		VideoPreset p;
+		p.follow_body = pn.get<String>( "follow_body", GetStudioSetting<String>( "viewer.camera_follow_body" ) );
+		p.orbit_speed = pn.get<double>( "orbit_speed", p.orbit_speed );
+		p.distance = pn.get<double>( "distance", p.distance );
+		p.yaw = pn.get<double>( "yaw", p.yaw );
+		p.pitch = pn.get<double>( "pitch", p.pitch );
+		p.fov = pn.get<double>( "fov", p.fov );
+		p.focus_height = pn.get<double>( "focus_height", p.focus_height );
+		p.slow_motion = pn.get<double>( "slow_motion", p.slow_motion );
+		p.width = pn.get<int>( "width", GetStudioSetting<int>( "video.width" ) );
+		p.height = pn.get<int>( "height", GetStudioSetting<int>( "video.height" ) );
+		p.frame_rate = pn.get<double>( "frame_rate", GetStudioSetting<double>( "video.frame_rate" ) );
+		p.quality = pn.get<int>( "quality", GetStudioSetting<int>( "video.quality" ) );
+		if ( auto* vo = pn.try_get_child( "view_options" ) ) {
+			for ( const auto& [key, value] : *vo ) {
+				auto it = std::find_if( std::begin( view_option_names ), std::end( view_option_names ), [&]( const auto& n ) { return key == n.first; } );
+				SCONE_ERROR_IF( it == std::end( view_option_names ), "Unknown view option: " + key );
+				p.view_options.set( it->second, value.get<bool>() );
+			}
+		}
+		return p;
+	}
+
+	BatchVideoExport::BatchVideoExport( const QStringList& files, const VideoPreset& preset, const QString& outputFolder, int max_jobs, int threads ) :
+		files_( files ),
+		preset_( preset ),
+		output_folder_( outputFolder ),
+		results_( files.size() ),
+		next_file_( 0 ),
+		finished_count_( 0 ),
+		cancel_( false )
+	{
+		// meshes are loaded once and shared between all scenes of all jobs
+		osg::ref_ptr<osgDB::Options> options = osgDB::Registry::instance()->getOptions() ?
+			new osgDB::Options( *osgDB::Registry::instance()->getOptions() ) : new osgDB::Options;
+		options->setObjectCacheHint( osgDB::Options::CACHE_ALL );
+		osgDB::Registry::instance()->setOptions( options.get() );
+
+		auto num_jobs = std::max( 1, std::min( max_jobs, int( files_.size() ) ) );
+		auto total_threads = threads > 0 ? threads : int( std::max( 1u, std::thread::hardware_concurrency() ) );
+		render_threads_ = std::max( 1, total_threads / num_jobs );
+		for ( int i = 0; i < num_jobs; ++i )
+			threads_.emplace_back( &BatchVideoExport::threadFunc, this );
+	}
+
+	BatchVideoExport::~BatchVideoExport()
+	{
+		cancel();
+		wait();
+	}
+
+	void BatchVideoExport::cancel()
+	{
+		cancel_ = true;
+	}
+
+	void BatchVideoExport::wait()
+	{
+		for ( auto& t : threads_ )
+			if ( t.joinable() )
+				t.join();
+	}
+
+	void BatchVideoExport::threadFunc()
+	{
+		for ( size_t idx = next_file_++; idx < size_t( files_.size() ); idx = next_file_++ )
+		{
+			// each result is written by a single thread
+			if ( !cancel_ )
+				results_[ idx ] = exportVideo( files_[ int( idx ) ] );
+			else {
+				results_[ idx ].file = files_[ int( idx ) ];
+				results_[ idx ].error = "Cancelled";
+			}
+			++finished_count_;
+		}
+	}
+
+	BatchVideoExport::Result BatchVideoExport::exportVideo( const QString& file )
+	{
+		Result r;
+		r.file = file;
+		try
+		{
+			// get data, by reading .sto files or evaluating .par / .scone files
+			xo::timer evaluation_time;
+			auto file_path = path_from_qt( file );
+			Storage<> data;
+			auto ext = file_path.extension_no_dot();
+			if ( ext == "sto" || ext == "stob" )
+				ReadStorage( data, file_path );
+			else {
+				auto [optimizer, model] = CreateOptimizerAndModel( file_path );
+				auto& mo = dynamic_cast<ModelObjective&>( optimizer->GetObjective() );
+				model->SetStoreData( true );
+				mo.AdvanceSimulationTo( *model, model->GetSimulationEndTime() );
+				data = model->GetData();
+			}
+			SCONE_ERROR_IF( data.IsEmpty(), "No data found for " + file_path.str() );
+			r.sim_time = data.GetFrame( data.GetFrameCount() - 1 ).GetTime();
+			r.evaluation_time = evaluation_time().secondsd();
+
+			QFileInfo fi( file );
+			auto folder = output_folder_.isEmpty() ? fi.dir() : QDir( output_folder_ );
+			r.video_file = folder.filePath( fi.completeBaseName() + ".mp4" );
+
+			xo::timer render_time;
+			VideoEncoderSettings ves;
+			ves.ffmpeg = to_qt( GetStudioSetting<path>( "video.path_to_ffmpeg" ) );
+			ves.filename = r.video_file;
+			ves.width = preset_.width;
+			ves.height = preset_.height;
+			ves.frame_rate = preset_.frame_rate;
+			ves.quality = preset_.quality;
+			VideoEncoder encoder( ves );
+			SCONE_ERROR_IF( !encoder.waitForStarted(), encoder.errorString().toStdString() );
+
+			// camera is defined relative to the follow point at the start of the simulation
+			OffscreenRenderSettings ors;
+			ors.width = preset_.width;
+			ors.height = preset_.height;
+			ors.time_step = preset_.slow_motion / preset_.frame_rate;
+			ors.frame_count = int( r.sim_time / ors.time_step ) + 1;
+			ors.reference_time = 0.0;
+			ors.view_options = preset_.view_options;
+			ors.follow_body = preset_.follow_body;
+			ors.orbit_speed = preset_.orbit_speed;
+			auto yaw = Radian( Degree( preset_.yaw ) ).value, pitch = Radian( Degree( preset_.pitch ) ).value;
+			osg::Vec3d focus( 0.0, preset_.focus_height, 0.0 );
+			osg::Vec3d eye = focus + osg::Vec3d( std::sin( yaw ) * std::cos( pitch ), std::sin( pitch ), std::cos( yaw ) * std::cos( pitch ) ) * preset_.distance;
+			ors.view_matrix = osg::Matrixd::lookAt( eye, focus, osg::Vec3d( 0, 1, 0 ) );
+			ors.view_relative_to_reference = true;
+			ors.projection_matrix = osg::Matrixd::perspective( preset_.fov, double( preset_.width ) / preset_.height, 0.1, 1000.0 );
+			ors.clear_color = vis::to_osg( GetStudioSetting<xo::color>( "viewer.background" ) );
+			ors.ambient_intensity = GetStudioSetting<float>( "viewer.ambient_intensity" );
+			ors.threads = render_threads_;
+
+			OffscreenRenderer renderer( file_path, std::move( data ), ors, encoder );
+			while ( !renderer.waitForFinished( 100 ) )
+				if ( cancel_ )
+					renderer.abort();
+			SCONE_ERROR_IF( !renderer.errorString().isEmpty(), renderer.errorString().toStdString() );
+
+			encoder.finish();
+			while ( !encoder.waitForFinished( 100 ) ) {}
+			SCONE_ERROR_IF( !encoder.errorString().isEmpty(), encoder.errorString().toStdString() );
+			r.frames = encoder.framesEncoded();
+			r.render_time = render_time().secondsd();
+			log::info( "Created ", r.video_file.toStdString(), "; frames=", r.frames, " render_time=", r.render_time, "s" );
+		}
+		catch ( const std::exception& e )
+		{
+			r.error = e.what();
+			log::error( "Error creating video for ", file.toStdString(), ": ", e.what() );
+		}
+		return r;
+	}
+
+	bool BatchVideoExport::writeSummary( const QString& filename ) const
+	{
+		QFile file( filename );
+		if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+			return false;
+		QTextStream str( &file );
+		writeSummary( str );
+		return true;
+	}
+
+	void BatchVideoExport::writeSummary( QTextStream& str ) const
+	{
+		str << "file\tvideo\tframes\tsim_time\tevaluation_time\trender_time\tframes_per_second\terror\n";
+		for ( const auto& r : results_ )
+			str << r.file << '\t' << r.video_file << '\t' << r.frames << '\t' << r.sim_time << '\t' << r.evaluation_time << '\t'
+			<< r.render_time << '\t' << ( r.render_time > 0.0 ? r.frames / r.render_time : 0.0 ) << '\t' << QString( r.error ).replace( '\n', ' ' ) << '\n';
+	}
+}
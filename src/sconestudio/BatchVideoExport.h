@@ -0,0 +1,88 @@
+/*
+** BatchVideoExport.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "scone/core/types.h"
+#include "scone/core/PropNode.h"
+#include "ViewOptions.h"
+
+class QTextStream;
+
+namespace scone
+{
+	/// Camera and view settings for rendering videos without a viewer
+	struct VideoPreset {
+		ViewOptions view_options = MakeDefaultViewOptions();
+		String follow_body; // empty to follow the model center of mass
+		double orbit_speed = 0.0; // degrees per second simulation time
+		double distance = 4.0; // camera distance to the focus point
+		double yaw = 0.0; // camera direction in degrees, 0 = looking from +z
+		double pitch = 15.0; // camera elevation in degrees
+		double fov = 30.0; // vertical field of view in degrees
+		double focus_height = 1.0;
+		double slow_motion = 1.0;
+		int width = 1024;
+		int height = 768;
+		double frame_rate = 30.0;
+		int quality = 2;
+	};
+
+	/// Create a preset from a prop_node, missing values are taken from the studio settings or defaults.
+	/// View options can be set in a view_options child, e.g. view_options { muscles = 1 tendons = 0 }
+	VideoPreset MakeVideoPreset( const PropNode& pn );
+
+	/// Renders videos for multiple result files offscreen, without a viewer.
+	/// Multiple files are rendered concurrently, each using multiple render threads.
+	class BatchVideoExport
+	{
+	public:
+		struct Result {
+			QString file;
+			QString video_file;
+			int frames = 0;
+			double sim_time = 0.0;
+			double evaluation_time = 0.0; // time to evaluate .par / .scone files, or to read .sto files
+			double render_time = 0.0; // time to render and encode all frames
+			QString error;
+		};
+
+		/// max_jobs is the number of concurrent files, threads is the total number of render threads (0 = hardware)
+		BatchVideoExport( const QStringList& files, const VideoPreset& preset, const QString& outputFolder, int max_jobs = 2, int threads = 0 );
+		~BatchVideoExport();
+
+		void cancel();
+		void wait();
+		int finishedCount() const { return int( finished_count_ ); }
+
+		/// results in the order of the input files, only valid after wait()
+		const std::vector<Result>& results() const { return results_; }
+
+		bool writeSummary( const QString& filename ) const;
+		void writeSummary( QTextStream& str ) const;
+
+	private:
+		void threadFunc();
+		Result exportVideo( const QString& file );
+
+		QStringList files_;
+		VideoPreset preset_;
+		QString output_folder_;
+		int render_threads_;
+		std::vector<Result> results_;
+		std::vector<std::thread> threads_;
+		std::atomic<size_t> next_file_;
+		std::atomic<size_t> finished_count_;
+		std::atomic<bool> cancel_;
+	};
+}
@@ -0,0 +1,222 @@
+/*
+** BenchmarkSuite.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "BenchmarkSuite.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <map>
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+#include "scone/core/profiler_config.h"
+#include "scone/optimization/ModelObjective.h"
+#include "xo/time/timer.h"
+#include "BatchEvaluation.h"
+#include "qt_convert.h"
+
+namespace scone
+{
+	double median( std::vector<double> v )
+	{
+		if ( v.empty() )
+			return 0.0;
+		std::sort( v.begin(), v.end() );
+		auto n = v.size();
+		return n % 2 == 1 ? v[ n / 2 ] : 0.5 * ( v[ n / 2 - 1 ] + v[ n / 2 ] );
+	}
+
+	BenchmarkResult BenchmarkScenarioFile( const QString& file, const BenchmarkSuiteOptions& opt )
+	{
+		BenchmarkResult r;
+		r.scenario = file;
+		try
+		{
+			auto [optimizer, model] = CreateOptimizerAndModel( path_from_qt( file ) );
+			auto& mo = dynamic_cast<ModelObjective&>( optimizer->GetObjective() );
+			const auto par = SearchPoint( mo.info() );
+
+			// returns real time and simulated time, model creation is not included
+			auto evaluate = [&]( PropNode* profile ) {
+				auto p = par;
+				auto m = mo.CreateModelFromParams( p );
+				m->SetStoreData( false );
+				xo::timer t;
+				mo.AdvanceSimulationTo( *m, m->GetSimulationEndTime() );
+				auto duration = t().secondsd();
+				if ( profile && m->GetProfiler().enabled() )
+					*profile = m->GetProfiler().report();
+				return std::make_pair( duration, double( m->GetTime() ) );
+			};
+
+			for ( int i = 0; i < opt.warmup; ++i )
+				evaluate( nullptr );
+
+			// measure samples concurrently, like during optimization
+			std::vector<double> samples( opt.samples );
+			std::atomic<int> next_sample = 0;
+			auto worker = [&]() {
+				for ( int i = next_sample++; i < opt.samples; i = next_sample++ ) {
+					auto [real_time, sim_time] = evaluate( nullptr );
+					samples[ i ] = real_time;
+					if ( i == 0 )
+						r.sim_time = sim_time;
+				}
+			};
+			auto num_threads = std::min( opt.threads > 0 ? opt.threads : int( std::thread::hardware_concurrency() ), opt.samples );
+			xo::timer wall_time;
+			std::vector<std::thread> threads;
+			for ( int i = 1; i < num_threads; ++i )
+				threads.emplace_back( worker );
+			worker();
+			for ( auto& t : threads )
+				t.join();
+			r.evaluations_per_second = opt.samples / wall_time().secondsd();
+
+			// reject outliers using the median absolute deviation, scaled to match stddev for normal distributions
+			auto med = median( samples );
+			std::vector<double> deviations( samples.size() );
+			std::transform( samples.begin(), samples.end(), deviations.begin(), [&]( double s ) { return std::abs( s - med ); } );
+			auto mad = 1.4826 * median( deviations );
+			for ( auto s : samples ) {
+				if ( mad > 0.0 && std::abs( s - med ) > opt.outlier_threshold * mad )
+					++r.rejected;
+				else r.samples.push_back( s );
+			}
+
+			auto n = double( r.samples.size() );
+			SCONE_ERROR_IF( r.samples.empty(), "No valid samples" );
+			r.median = median( r.samples );
+			r.mean = std::accumulate( r.samples.begin(), r.samples.end(), 0.0 ) / n;
+			r.stddev = std::sqrt( std::accumulate( r.samples.begin(), r.samples.end(), 0.0,
+				[&]( double acc, double s ) { return acc + ( s - r.mean ) * ( s - r.mean ); } ) / n );
+			SCONE_ERROR_IF( r.median <= 0.0, "Median evaluation time is zero" ); // would give an infinite real-time factor
+			r.realtime_factor = r.sim_time / r.median;
+
+			// profiler breakdown from a separate run, because profiling affects timing
+			auto profiler_previously_enabled = SetProfilerEnabled( true );
+			evaluate( &r.profile );
+			SetProfilerEnabled( profiler_previously_enabled );
+
+			log::info( file.toStdString(), ": median=", r.median, "s realtime_factor=", r.realtime_factor, " rejected=", r.rejected );
+		}
+		catch ( const std::exception& e )
+		{
+			r.error = e.what();
+			log::error( "Error benchmarking ", file.toStdString(), ": ", e.what() );
+		}
+		return r;
+	}
+
+	std::vector<BenchmarkResult> RunBenchmarkSuite( const QString& folder, const BenchmarkSuiteOptions& opt )
+	{
+		SCONE_ERROR_IF( opt.samples < 1, "Number of benchmark samples must be at least 1" );
+		QStringList files;
+		for ( QDirIterator it( folder, { "*.scone" }, QDir::Files, QDirIterator::Subdirectories ); it.hasNext(); )
+			files.push_back( it.next() );
+		files.sort();
+
+		// scenarios are benchmarked one at a time, so they don't affect each other's timing
+		std::vector<BenchmarkResult> results;
+		for ( const auto& f : files ) {
+			results.push_back( BenchmarkScenarioFile( f, opt ) );
+			results.back().name = QDir( folder ).relativeFilePath( f );
+		}
+		return results;
+	}
+
+	QJsonValue toJson( const PropNode& pn )
+	{
+		if ( pn.size() == 0 )
+			return QString::fromStdString( pn.raw_value() );
+		QJsonObject obj;
+		if ( !pn.raw_value().empty() )
+			obj[ "value" ] = QString::fromStdString( pn.raw_value() );
+		for ( const auto& [key, child] : pn )
+			obj[ QString::fromStdString( key ) ] = toJson( child );
+		return obj;
+	}
+
+	bool WriteBenchmarkJson( const std::vector<BenchmarkResult>& results, const QString& filename )
+	{
+		QJsonArray scenarios;
+		for ( const auto& r : results )
+		{
+			QJsonObject obj;
+			obj[ "scenario" ] = r.scenario;
+			obj[ "name" ] = r.name;
+			if ( !r.error.isEmpty() )
+				obj[ "error" ] = r.error;
+			obj[ "sim_time" ] = r.sim_time;
+			obj[ "samples" ] = int( r.samples.size() );
+			obj[ "rejected" ] = r.rejected;
+			obj[ "median" ] = r.median;
+			obj[ "mean" ] = r.mean;
+			obj[ "stddev" ] = r.stddev;
+			obj[ "realtime_factor" ] = r.realtime_factor;
+			obj[ "evaluations_per_second" ] = r.evaluations_per_second;
+			obj[ "profile" ] = toJson( r.profile );
+			scenarios.append( obj );
+		}
+
+		QFile file( filename );
+		if ( !file.open( QIODevice::WriteOnly ) )
+			return false;
+		file.write( QJsonDocument( QJsonObject{ { "scenarios", scenarios } } ).toJson() );
+		return true;
+	}
+
+	bool WriteBenchmarkCsv( const std::vector<BenchmarkResult>& results, const QString& filename )
+	{
+		QFile file( filename );
+		if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+			return false;
+		QTextStream str( &file );
+		str << "scenario,sim_time,samples,rejected,median,mean,stddev,realtime_factor,evaluations_per_second,error\n";
+		for ( const auto& r : results )
+			str << '"' << r.scenario << "\"," << r.sim_time << ',' << r.samples.size() << ',' << r.rejected << ',' << r.median << ','
+			<< r.mean << ',' << r.stddev << ',' << r.realtime_factor << ',' << r.evaluations_per_second << ",\"" << QString( r.error ).replace( '"', '\'' ) << "\"\n";
+		return true;
+	}
+
+	QStringList FindBenchmarkRegressions( const std::vector<BenchmarkResult>& results, const QString& baselineFile, double threshold )
+	{
+		QFile file( baselineFile );
+		if ( !file.open( QIODevice::ReadOnly ) )
+			return { "Could not open baseline " + baselineFile };
+
+		// scenarios are matched by relative path, so a baseline can be used from a different folder
+		// and scenarios with the same file name in different sub folders are kept apart
+		std::map<QString, double> baseline;
+		for ( const auto& v : QJsonDocument::fromJson( file.readAll() ).object()[ "scenarios" ].toArray() )
+			baseline[ v.toObject()[ "name" ].toString() ] = v.toObject()[ "realtime_factor" ].toDouble();
+
+		QStringList regressions;
+		for ( const auto& r : results )
+		{
+			auto it = baseline.find( r.name );
+			if ( it == baseline.end() || it->second <= 0.0 )
+				continue;
+			if ( !r.error.isEmpty() )
+				regressions.push_back( QString( "%1: %2" ).arg( r.scenario, r.error ) );
+			else if ( r.realtime_factor < ( 1.0 - threshold ) * it->second )
+				regressions.push_back( QString( "%1: real-time factor %2 < %3 (baseline)" ).arg( r.scenario ).arg( r.realtime_factor ).arg( it->second ) );
+		}
+		return regressions;
+	}
+}
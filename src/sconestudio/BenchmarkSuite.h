@@ -0,0 +1,51 @@
+/*
+** BenchmarkSuite.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "scone/core/PropNode.h"
+
+namespace scone
+{
+	struct BenchmarkSuiteOptions {
+		int samples = 10; // number of evaluations per scenario, after warm-up
+		int warmup = 2; // number of evaluations per scenario that are not measured
+		int threads = 0; // number of concurrent evaluations, 0 = hardware concurrency
+		double outlier_threshold = 3.0; // samples further than this many (scaled) median absolute deviations are rejected
+		double regression_threshold = 0.05; // relative drop in real-time factor that counts as a regression
+	};
+
+	struct BenchmarkResult {
+		QString scenario;
+		QString name; // scenario path relative to the benchmarked folder, used to match baselines
+		double sim_time = 0.0;
+		std::vector<double> samples; // real time per evaluation, excluding rejected outliers
+		int rejected = 0;
+		double median = 0.0;
+		double mean = 0.0;
+		double stddev = 0.0;
+		double realtime_factor = 0.0; // simulated time / median real time
+		double evaluations_per_second = 0.0; // throughput of all threads combined
+		PropNode profile;
+		QString error;
+	};
+
+	/// Benchmark all .scone files in a folder (including sub folders), each with multiple concurrent evaluations
+	/// Throws if opt.samples < 1, scenarios without valid samples get an error
+	std::vector<BenchmarkResult> RunBenchmarkSuite( const QString& folder, const BenchmarkSuiteOptions& opt );
+
+	bool WriteBenchmarkJson( const std::vector<BenchmarkResult>& results, const QString& filename );
+	bool WriteBenchmarkCsv( const std::vector<BenchmarkResult>& results, const QString& filename );
+
+	/// Compare with a JSON file written by WriteBenchmarkJson, returns a message for each scenario that has regressed
+	/// Scenarios are matched by their path relative to the benchmarked folder
+	QStringList FindBenchmarkRegressions( const std::vector<BenchmarkResult>& results, const QString& baselineFile, double threshold );
+}
@@ -8,7 +8,7 @@
 #include "scone/model/Dof.h"
 #include "qt_convert.h"
 #include "xo/system/log.h"
-#include "gui_profiler.h"
+#include "studio_profiler.h"
 
 namespace scone
 {
@@ -19,7 +19,7 @@ namespace scone
 		useDegrees( dof.IsRotational() ),
 		stepSize_( useDegrees ? 0.1 : 0.01 )
 	{
-		GUI_PROFILE_FUNCTION;
+		STUDIO_PROFILE_FUNCTION;
 
 		auto decimals = xo::round_cast<int>( log10( 1 / stepSize_ ) );
 		bool useSpinLimits = false; // #todo: make this a setting
@@ -91,7 +91,7 @@ namespace scone
 		QWidget( parent ),
 		dofGrid( nullptr )
 	{
-		GUI_PROFILE_FUNCTION;
+		STUDIO_PROFILE_FUNCTION;
 
 		QVBoxLayout* wl = new QVBoxLayout( this );
 		wl->setContentsMargins( 0, 0, 0, 0 );
@@ -136,7 +136,7 @@ namespace scone
 
 	void DofEditorGroup::init( const Model& model )
 	{
-		GUI_PROFILE_FUNCTION;
+		STUDIO_PROFILE_FUNCTION;
 
 		dofEditors.clear();
 		qDeleteAll( dofGrid->findChildren<QWidget*>( "", Qt::FindDirectChildrenOnly ) );
@@ -156,7 +156,7 @@ namespace scone
 
 	void DofEditorGroup::setSlidersFromDofs( const Model& model )
 	{
-		GUI_PROFILE_FUNCTION;
+		STUDIO_PROFILE_FUNCTION;
 
 		blockSignals( true );
 		const auto& dofs = model.GetDofs();
@@ -168,7 +168,7 @@ namespace scone
 
 	void DofEditorGroup::setDofsFromSliders( Model& model )
 	{
-		GUI_PROFILE_FUNCTION;
+		STUDIO_PROFILE_FUNCTION;
 
 		const auto& dofs = model.GetDofs();
 		SCONE_ASSERT( dofs.size() == dofEditors.size() );
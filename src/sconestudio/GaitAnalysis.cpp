@@ -49,10 +49,8 @@ namespace scone
 		else log::error( "Error loading gait analysis template: ", ec.message() );
 	}
 
-	void GaitAnalysis::update( const Storage<>& sto, const path& filename )
+	GaitSummary ExtractGaitSummary( const Storage<>& sto )
 	{
-		log::debug( "Performing Gait Analysis on ",filename );
-		log::flush();
 		GaitCycleExtractionSettings cfg;
 		cfg.touch_force_threshold = GetStudioSetting<Real>( "gait_analysis.force_threshold" );
 		cfg.min_swing_duraction = GetStudioSetting<Real>( "gait_analysis.min_stance_duration" );
@@ -61,12 +59,33 @@ namespace scone
 		auto skip_total = skip_first + skip_last;
 		auto cycles = ExtractGaitCycles( sto, cfg );
 
-		std::vector<double> scores;
+		GaitSummary s;
 		if ( cycles.size() > skip_total )
 		{
 			cycles.erase( cycles.begin(), cycles.begin() + skip_first );
 			cycles.erase( cycles.end() - skip_last, cycles.end() );
 
+			auto f = 1.0 / cycles.size();
+			s.stride_length = f * std::accumulate( cycles.begin(), cycles.end(), 0.0,
+				[]( const auto& v, const auto& c ) { return v + c.length();  } );
+			s.stride_time = f * std::accumulate( cycles.begin(), cycles.end(), 0.0,
+				[]( const auto& v, const auto& c ) { return v + c.duration();  } );
+			s.speed = s.stride_length / s.stride_time;
+			s.cycles = std::move( cycles );
+		}
+		return s;
+	}
+
+	void GaitAnalysis::update( const Storage<>& sto, const path& filename )
+	{
+		log::debug( "Performing Gait Analysis on ",filename );
+		log::flush();
+		auto summary = ExtractGaitSummary( sto );
+		const auto& cycles = summary.cycles;
+
+		std::vector<double> scores;
+		if ( !cycles.empty() )
+		{
 			for ( auto* p : plots_ ) {
 				if ( auto em = p->update( sto, cycles ); em.bad() )
 					log::warning( em.message() );
@@ -74,12 +93,9 @@ namespace scone
 					scores.emplace_back( p->matchPercentage() );
 			}
 
-			auto f = 1.0 / cycles.size();
-			auto avg_length = f * std::accumulate( cycles.begin(), cycles.end(), 0.0,
-				[]( const auto& v, const auto& c ) { return v + c.length();  } );
-			auto avg_dur = f * std::accumulate( cycles.begin(), cycles.end(), 0.0,
-				[]( const auto& v, const auto& c ) { return v + c.duration();  } );
-			auto avg_speed = avg_length / avg_dur;
+			auto avg_length = summary.stride_length;
+			auto avg_dur = summary.stride_time;
+			auto avg_speed = summary.speed;
 			auto avg_score = xo::average( scores );
 
 			if ( GetStudioSetting<bool>( "gait_analysis.show_fit" ) )
@@ -2,10 +2,21 @@
 
 #include <QWidget>
 #include "scone/core/Storage.h"
+#include "scone/core/GaitCycle.h"
 #include <QGridLayout>
 
 namespace scone
 {
+	struct GaitSummary {
+		std::vector<GaitCycle> cycles;
+		double stride_length = 0.0;
+		double stride_time = 0.0;
+		double speed = 0.0;
+	};
+
+	/// Extract gait cycles and averages using the gait_analysis settings, empty if there are not enough cycles
+	GaitSummary ExtractGaitSummary( const Storage<>& sto );
+
 	class GaitAnalysis : public QWidget
 	{
 	public:
@@ -77,7 +77,7 @@ namespace scone
 		}
 
 		// event bounds
-		if ( GetStudioSetting<int>( "gait_analysis.show_swing_start" ) != 0 && norm_event_ ) {
+		if ( GetStudioSettingsSnapshot().gait_analysis.show_swing_start != 0 && norm_event_ ) {
 			auto* bar = new QCPItemRect( plot_ );
 			bar->topLeft->setCoords( norm_event_->lower, y_min_ );
 			bar->bottomRight->setCoords( norm_event_->upper, y_max_ );
@@ -129,9 +129,10 @@ namespace scone
 			return "Could not find " + left_channel_.str() + " / " + right_channel_.str() + "; please verify Tools->Preferences->Data";
 
 		// get settings (read here so they can be updated)
-		bool plot_cycles = GetStudioSetting<bool>( "gait_analysis.plot_individual_cycles" );
-		int show_swing_start = GetStudioSetting<int>( "gait_analysis.show_swing_start" );
-		Real lookahead = sto.GetAverageFrameDuration() * GetStudioSetting<Real>( "gait_analysis.plot_step_frame_lead" );
+		const auto& ga_settings = GetStudioSettingsSnapshot().gait_analysis;
+		bool plot_cycles = ga_settings.plot_individual_cycles;
+		int show_swing_start = ga_settings.show_swing_start;
+		Real lookahead = sto.GetAverageFrameDuration() * ga_settings.plot_step_frame_lead;
 
 		// plot cycles and gather range and avg data
 		xo::boundsd range( y_min_, y_max_ );
@@ -198,7 +199,7 @@ namespace scone
 				error += xo::abs( r.get_excess( xo::lerp_map( avg_data, x ) ) ) / xo::max( 0.01, r.length() );
 			error /= norm_data_.size();
 			match_percentage_ = 100.0 * xo::clamped( 1.0 - error, 0.0, 1.0 );
-			if ( plot_title_ && GetStudioSetting<bool>( "gait_analysis.show_fit" ) )
+			if ( plot_title_ && ga_settings.show_fit )
 				plot_title_->setText( title_.c_str() + QString::asprintf( " (%.1f%%)", match_percentage_ ) );
 		}
 		plot_->yAxis->setRange( range.lower, range.upper );
@@ -1,6 +1,7 @@
 #include "ModelVis.h" 
 
 #include "StudioSettings.h"
+#include "TraceRecorder.h"
 #include "vis/scene.h"
 #include "xo/filesystem/filesystem.h"
 #include "scone/core/Log.h"
@@ -18,49 +19,51 @@ namespace scone
 {
 	using namespace xo::angle_literals;
 
+	static const auto& ViewerSettings() { return GetStudioSettingsSnapshot().viewer; }
+
 	ModelVis::ModelVis( const Model& model, vis::scene& s, const ViewOptions& settings ) :
 		view_flags( settings ),
-		ground_tile_size_( GetStudioSetting<float>( "viewer.tile_size" ) ),
-		ground_follows_com_( GetStudioSetting<bool>( "viewer.tiles_follow_body" ) ),
+		ground_tile_size_( ViewerSettings().tile_size ),
+		ground_follows_com_( ViewerSettings().tiles_follow_body ),
 		root_node_( &s ),
-		specular_( GetStudioSetting<float>( "viewer.specular" ) ),
-		shininess_( GetStudioSetting<float>( "viewer.shininess" ) ),
-		ambient_( GetStudioSetting<float>( "viewer.ambient" ) ),
-		combine_contact_forces_( GetStudioSetting<int>( "viewer.combine_contact_forces" ) ),
-		forces_cast_shadows_( GetStudioSetting<bool>( "viewer.forces_cast_shadows" ) ),
-		joint_forces_are_for_parents_( GetStudioSetting<bool>( "viewer.joint_forces_are_for_parents" ) ),
-		joint_arrow_length_( GetStudioSetting<float>( "viewer.joint_arrow_length" ) ),
-		force_arrow_length_( GetStudioSetting<float>( "viewer.force_arrow_length" ) ),
-		arrow_shape_( GetStudioSetting<float>( "viewer.arrow_shape" ) ),
-		fixed_muscle_width_( GetStudioSetting<float>( "viewer.muscle_width" ) ),
-		spring_width_( GetStudioSetting<float>( "viewer.spring_width" ) ),
-		body_axes_length_( GetStudioSetting<float>( "viewer.body_axes_length" ) ),
-		bone_color( GetStudioSetting<xo::color>( "viewer.bone" ) ),
+		specular_( ViewerSettings().specular ),
+		shininess_( ViewerSettings().shininess ),
+		ambient_( ViewerSettings().ambient ),
+		combine_contact_forces_( ViewerSettings().combine_contact_forces ),
+		forces_cast_shadows_( ViewerSettings().forces_cast_shadows ),
+		joint_forces_are_for_parents_( ViewerSettings().joint_forces_are_for_parents ),
+		joint_arrow_length_( ViewerSettings().joint_arrow_length ),
+		force_arrow_length_( ViewerSettings().force_arrow_length ),
+		arrow_shape_( ViewerSettings().arrow_shape ),
+		fixed_muscle_width_( ViewerSettings().muscle_width ),
+		spring_width_( ViewerSettings().spring_width ),
+		body_axes_length_( ViewerSettings().body_axes_length ),
+		bone_color( ViewerSettings().bone ),
 		bone_mat( { bone_color, specular_, shininess_, ambient_ } ),
-		joint_color( GetStudioSetting<xo::color>( "viewer.joint" ) ),
+		joint_color( ViewerSettings().joint ),
 		joint_mat( { joint_color, specular_, shininess_, ambient_ } ),
-		com_mat( { GetStudioSetting<xo::color>( "viewer.com" ), specular_, shininess_, ambient_ } ),
-		muscle_mat( { GetStudioSetting<xo::color>( "viewer.muscle_0" ), specular_, shininess_, ambient_ } ),
-		tendon_mat( { GetStudioSetting<xo::color>( "viewer.tendon" ), specular_, shininess_, ambient_ } ),
-		ligament_mat( { GetStudioSetting<xo::color>( "viewer.ligament" ), specular_, shininess_, ambient_ } ),
-		spring_mat( { GetStudioSetting<xo::color>( "viewer.spring" ), specular_, shininess_, ambient_ } ),
-		force_mat( { GetStudioSetting<xo::color>( "viewer.force" ), specular_, shininess_, ambient_, GetStudioSetting<float>( "viewer.force_alpha" ) } ),
-		joint_force_mat( { GetStudioSetting<xo::color>( "viewer.joint_force" ), specular_, shininess_, ambient_, GetStudioSetting<float>( "viewer.force_alpha" ) } ),
-		moment_mat( { GetStudioSetting<xo::color>( "viewer.moment" ), specular_, shininess_, ambient_ } ),
-		contact_mat( { GetStudioSetting<xo::color>( "viewer.contact" ), specular_, shininess_, ambient_, GetStudioSetting<float>( "viewer.contact_alpha" ) } ),
-		auxiliary_mat( { GetStudioSetting<xo::color>( "viewer.auxiliary" ), specular_, shininess_, ambient_, GetStudioSetting<float>( "viewer.auxiliary_alpha" ) } ),
-		auxiliary_opaque_mat( { GetStudioSetting<xo::color>( "viewer.auxiliary" ), specular_, shininess_, ambient_ } ),
-		static_mat( { GetStudioSetting<xo::color>( "viewer.static" ), 0.0f, 0.0f, ambient_ } ),
-		object_mat( { GetStudioSetting<xo::color>( "viewer.object" ), 0.0f, 0.0f, ambient_ } ),
+		com_mat( { ViewerSettings().com, specular_, shininess_, ambient_ } ),
+		muscle_mat( { ViewerSettings().muscle_0, specular_, shininess_, ambient_ } ),
+		tendon_mat( { ViewerSettings().tendon, specular_, shininess_, ambient_ } ),
+		ligament_mat( { ViewerSettings().ligament, specular_, shininess_, ambient_ } ),
+		spring_mat( { ViewerSettings().spring, specular_, shininess_, ambient_ } ),
+		force_mat( { ViewerSettings().force, specular_, shininess_, ambient_, ViewerSettings().force_alpha } ),
+		joint_force_mat( { ViewerSettings().joint_force, specular_, shininess_, ambient_, ViewerSettings().force_alpha } ),
+		moment_mat( { ViewerSettings().moment, specular_, shininess_, ambient_ } ),
+		contact_mat( { ViewerSettings().contact, specular_, shininess_, ambient_, ViewerSettings().contact_alpha } ),
+		auxiliary_mat( { ViewerSettings().auxiliary, specular_, shininess_, ambient_, ViewerSettings().auxiliary_alpha } ),
+		auxiliary_opaque_mat( { ViewerSettings().auxiliary, specular_, shininess_, ambient_ } ),
+		static_mat( { ViewerSettings().static_geom, 0.0f, 0.0f, ambient_ } ),
+		object_mat( { ViewerSettings().object, 0.0f, 0.0f, ambient_ } ),
 		muscle_gradient( {
-			{ -1.0f, GetStudioSetting<xo::color>( "viewer.muscle_min100" ) },
-			{ 0.0f, GetStudioSetting<xo::color>( "viewer.muscle_0" ) },
-			{ 0.5f, GetStudioSetting<xo::color>( "viewer.muscle_50" ) },
-			{ 1.0f, GetStudioSetting<xo::color>( "viewer.muscle_100" ) }
+			{ -1.0f, ViewerSettings().muscle_min100 },
+			{ 0.0f, ViewerSettings().muscle_0 },
+			{ 0.5f, ViewerSettings().muscle_50 },
+			{ 1.0f, ViewerSettings().muscle_100 }
 			} ),
 		ligament_gradient( {
-			{ 0.0f, GetStudioSetting<xo::color>( "viewer.ligament" ) },
-			{ 1.0f, GetStudioSetting<xo::color>( "viewer.ligament_100" ) }
+			{ 0.0f, ViewerSettings().ligament },
+			{ 1.0f, ViewerSettings().ligament_100 }
 			} ),
 		color_materials_( [&]( const xo::color& c ) { return vis::material( { c, specular_, shininess_, ambient_, c.a } ); } )
 	{
@@ -68,10 +71,10 @@ namespace scone
 		if ( auto* gp = model.GetGroundPlane() )
 		{
 			auto& plane = std::get<xo::plane>( gp->GetShape() );
-			auto col1 = GetStudioSetting<xo::color>( "viewer.tile1" );
-			auto col2 = GetStudioSetting<xo::color>( "viewer.tile2" );
-			auto tile_count_x = GetStudioSetting<int>( "viewer.tile_count_x" );
-			auto tile_count_z = GetStudioSetting<int>( "viewer.tile_count_z" );
+			auto col1 = ViewerSettings().tile1;
+			auto col2 = ViewerSettings().tile2;
+			auto tile_count_x = ViewerSettings().tile_count_x;
+			auto tile_count_z = ViewerSettings().tile_count_z;
 			ground_ = vis::plane( root_node_, tile_count_x, tile_count_z, ground_tile_size_, col1, col2 );
 			auto normal_rot = xo::quat_from_directions( xo::vec3f::unit_y(), plane.normal_ );
 			//ground_plane = scene_.add< vis::plane >( xo::vec3f( 64, 0, 0 ), xo::vec3f( 0, 0, -64 ), GetFolder( SCONE_UI_RESOURCE_FOLDER ) / "stile160.png", 64, 64 );
@@ -185,16 +188,16 @@ namespace scone
 			// add the mesh to the right container
 			if ( geom_mesh ) {
 				geom_mesh.set_name( cg->GetName().c_str() );
-				geom_mesh.set_cast_shadows( GetStudioSetting<bool>( "viewer.contact_geometries_cast_shadows" ) );
+				geom_mesh.set_cast_shadows( ViewerSettings().contact_geometries_cast_shadows );
 				auto& geom_cont = is_static ? static_contact_geoms : is_object_geom ? object_contact_geoms : contact_geoms;
 				geom_cont.push_back( std::move( geom_mesh ) );
 			}
 		}
 
-		const auto auto_muscle_width = GetStudioSetting<bool>( "viewer.auto_muscle_width" );
-		const auto auto_muscle_width_factor = GetStudioSetting<float>( "viewer.auto_muscle_width_factor" );
-		const auto relative_tendon_width = GetStudioSetting<float>( "viewer.relative_tendon_width" );
-		const auto muscle_position = GetStudioSetting<float>( "viewer.muscle_position" );
+		const auto auto_muscle_width = ViewerSettings().auto_muscle_width;
+		const auto auto_muscle_width_factor = ViewerSettings().auto_muscle_width_factor;
+		const auto relative_tendon_width = ViewerSettings().relative_tendon_width;
+		const auto muscle_position = ViewerSettings().muscle_position;
 
 		for ( const auto& muscle : model.GetIndividualMuscles() )
 		{
@@ -235,7 +238,7 @@ namespace scone
 			springs.push_back( std::move( sv ) );
 		}
 
-		const auto joint_radius = GetStudioSetting<float>( "viewer.joint_radius" );
+		const auto joint_radius = ViewerSettings().joint_radius;
 		for ( auto& j : model.GetJoints() )
 		{
 			auto& joint_node = joints.emplace_back( vis::node( &root_node_ ) );
@@ -267,6 +270,7 @@ namespace scone
 
 	void ModelVis::Update( const Model& model )
 	{
+		STUDIO_TRACE_FUNCTION( "visualization" );
 		index_t force_count = 0;
 		index_t moment_count = 0;
 
@@ -474,7 +478,7 @@ namespace scone
 
 	void ModelVis::UpdateShadowCast()
 	{
-		auto squared_dist = xo::squared( GetStudioSetting<float>( "viewer.max_shadow_dist" ) );
+		auto squared_dist = xo::squared( ViewerSettings().max_shadow_dist );
 		if ( view_flags( ViewOption::BodyGeom ) ) {
 			for ( index_t i = 1; i < bodies.size(); ++i ) // skip ground body; #todo: skip all static bodies?
 				bodies[i].node.set_cast_shadows( xo::squared_distance( bodies[i].node.pos(), focus_point_ ) < squared_dist );
@@ -13,6 +13,121 @@
 
 namespace scone
 {
+	void StoreMuscleData( Storage<Real>::Frame& frame, const Muscle& mus, const Dof& dof, bool muscleDetail )
+	{
+		const auto& model = mus.GetModel();
+		const auto& name = mus.GetName();
+
+		if ( muscleDetail ) {
+			frame[name + ".fiber_length"] = mus.GetFiberLength();
+			frame[name + ".tendon_length"] = mus.GetTendonLength();
+			frame[name + ".mtu_length"] = mus.GetLength();
+			frame[name + ".mtu_force"] = mus.GetForce();
+		}
+
+		// moment arms
+		bool all_moment_arms = false; // this is not always correct (e.g. deltoid), figure out why
+		frame[name + ".moment_arm"] = mus.GetMomentArm( dof ); // will be recalculated later
+		if ( muscleDetail )
+			frame[name + ".mtu_moment"] = mus.GetMoment( dof ); // will be recalculated later
+		if ( all_moment_arms ) {
+			for ( auto* d : mus.GetDofs() )
+				frame[name + "." + d->GetName() + ".moment_arm"] = mus.GetMomentArm( *d );
+		}
+
+		// tendon / mtu properties
+		frame[name + ".fiber_length_norm"] = mus.GetNormalizedFiberLength();
+		frame[name + ".tendon_length_norm"] = mus.GetNormalizedTendonLength() - 1;
+		frame[name + ".mtu_length_norm"] = mus.GetLength() / ( mus.GetOptimalFiberLength() + mus.GetTendonSlackLength() );
+		frame[name + ".mtu_force_norm"] = mus.GetNormalizedForce();
+
+		// fiber properties
+		frame[name + ".activation"] = mus.GetActivation();
+		frame[name + ".cos_pennation_angle"] = mus.GetCosPennationAngle();
+		frame[name + ".force_length_multiplier"] = mus.GetActiveForceLengthMultipler();
+	}
+
+	void StoreLigamentData( Storage<Real>::Frame& frame, const Ligament& lig, const Dof& dof, bool ligamentDetail )
+	{
+		const auto& model = lig.GetModel();
+		const auto& name = lig.GetName();
+
+		if ( ligamentDetail ) {
+			frame[name + ".length"] = lig.GetLength();
+			frame[name + ".force"] = lig.GetForce();
+		}
+
+		// moment arms
+		bool all_moment_arms = false; // this is not always correct (e.g. deltoid), figure out why
+		frame[name + ".moment_arm"] = lig.GetMomentArm( dof ); // will be recalculated later
+		if ( ligamentDetail )
+			frame[name + ".moment"] = lig.GetMoment( dof ); // will be recalculated later
+		if ( all_moment_arms ) {
+			for ( auto* d : lig.GetDofs() )
+				frame[name + "." + d->GetName() + ".moment_arm"] = lig.GetMomentArm( *d );
+		}
+
+		// lengths
+		frame[name + ".length_norm"] = lig.GetNormalizedLength();
+		frame[name + ".force_norm"] = lig.GetNormalizedForce();
+	}
+
+	BoundsDeg ComputeMuscleAnalysis( Model& model, Dof& dof, Storage<>& storage, bool muscleDetail, bool ligamentDetail )
+	{
+		storage.Clear();
+		auto rr = dof.GetRange();
+		BoundsDeg r = BoundsRad( rr.min, rr.max );
+		Real step_size = GetStudioSetting<Real>( "muscle_analysis.step_size" );
+		Real max_steps = GetStudioSetting<Real>( "muscle_analysis.max_steps" );
+		Degree step = std::max( Degree( step_size ), r.length() / max_steps );
+		for ( auto v = r.lower; v <= r.upper; v += step ) {
+			dof.SetPos( v.rad_value() );
+			model.InitStateFromDofs();
+			auto& f = storage.AddFrame( v.deg_value() );
+			for ( auto mus : model.GetMuscles() )
+				if ( mus->ActsOnDof( dof ) )
+					StoreMuscleData( f, *mus, dof, muscleDetail );
+			for ( auto lig : model.GetLigaments() )
+				if ( lig->ActsOnDof( dof ) )
+					StoreLigamentData( f, *lig, dof, ligamentDetail );
+		}
+		// compute moment arms using difference in mtu_length
+		SCONE_ASSERT( !storage.IsEmpty() );
+		for ( auto mus : model.GetMuscles() ) {
+			if ( mus->ActsOnDof( dof ) ) {
+				auto len_str = mus->GetName() + ".mtu_length_norm";
+				auto mom_str = mus->GetName() + ".moment_arm";
+				auto norm_factor = ( mus->GetOptimalFiberLength() + mus->GetTendonSlackLength() ) / ( step.rad_value() );
+				for ( int i = 0; i < storage.GetFrameCount(); ++i ) {
+					int i0 = std::max( 0, i - 1 ), i1 = std::min( (int)storage.GetFrameCount() - 1, i + 1 );
+					auto dl = storage.GetFrame( i1 )[len_str] - storage.GetFrame( i0 )[len_str];
+					auto moment_arm = norm_factor * -dl / ( i1 - i0 );
+					auto& frame = storage.GetFrame( i );
+					frame[mom_str] = moment_arm;
+					if ( muscleDetail )
+						frame[mus->GetName() + ".mtu_moment"] = moment_arm * frame[mus->GetName() + ".mtu_force"];
+				}
+			}
+		}
+		for ( auto lig : model.GetLigaments() ) {
+			if ( lig->ActsOnDof( dof ) ) {
+				auto len_str = lig->GetName() + ".length_norm";
+				auto mom_str = lig->GetName() + ".moment_arm";
+				auto norm_factor = lig->GetRestingLength() / step.rad_value();
+				for ( int i = 0; i < storage.GetFrameCount(); ++i ) {
+					int i0 = std::max( 0, i - 1 ), i1 = std::min( (int)storage.GetFrameCount() - 1, i + 1 );
+					auto dl = storage.GetFrame( i1 )[len_str] - storage.GetFrame( i0 )[len_str];
+					auto moment_arm = norm_factor * -dl / ( i1 - i0 );
+					auto& frame = storage.GetFrame( i );
+					frame[mom_str] = moment_arm;
+					if ( ligamentDetail )
+						frame[lig->GetName() + ".moment"] = moment_arm * frame[lig->GetName() + ".force"];
+				}
+			}
+		}
+		return r;
+	}
+
 	MuscleAnalysis::MuscleAnalysis( QWidget* parent ) :
 		storage(),
 		storageModel( &storage )
@@ -78,60 +193,10 @@ namespace scone
 		xo::timer t;
 		activeDof = FindByName( model.GetDofs(), dof_name.toStdString() );
 		dofName = dof_name;
-		storage.Clear();
 
 		State original_state = model.GetState();
 
-		auto rr = activeDof->GetRange();
-		BoundsDeg r = BoundsRad( rr.min, rr.max );
-		Real step_size = GetStudioSetting<Real>( "muscle_analysis.step_size" );
-		Real max_steps = GetStudioSetting<Real>( "muscle_analysis.max_steps" );
-		Degree step = std::max( Degree( step_size ), r.length() / max_steps );
-		for ( auto v = r.lower; v <= r.upper; v += step ) {
-			activeDof->SetPos( v.rad_value() );
-			model.InitStateFromDofs();
-			auto& f = storage.AddFrame( v.deg_value() );
-			for ( auto mus : model.GetMuscles() )
-				if ( mus->ActsOnDof( *activeDof ) )
-					StoreMuscleData( f, *mus, *activeDof );
-			for ( auto lig : model.GetLigaments() )
-				if ( lig->ActsOnDof( *activeDof ) )
-					StoreLigamentData( f, *lig, *activeDof );
-		}
-		// compute moment arms using difference in mtu_length
-		SCONE_ASSERT( !storage.IsEmpty() );
-		for ( auto mus : model.GetMuscles() ) {
-			if ( mus->ActsOnDof( *activeDof ) ) {
-				auto len_str = mus->GetName() + ".mtu_length_norm";
-				auto mom_str = mus->GetName() + ".moment_arm";
-				auto norm_factor = ( mus->GetOptimalFiberLength() + mus->GetTendonSlackLength() ) / ( step.rad_value() );
-				for ( int i = 0; i < storage.GetFrameCount(); ++i ) {
-					int i0 = std::max( 0, i - 1 ), i1 = std::min( (int)storage.GetFrameCount() - 1, i + 1 );
-					auto dl = storage.GetFrame( i1 )[len_str] - storage.GetFrame( i0 )[len_str];
-					auto moment_arm = norm_factor * -dl / ( i1 - i0 );
-					auto& frame = storage.GetFrame( i );
-					frame[mom_str] = moment_arm;
-					if ( muscleDetail )
-						frame[mus->GetName() + ".mtu_moment"] = moment_arm * frame[mus->GetName() + ".mtu_force"];
-				}
-			}
-		}
-		for ( auto lig : model.GetLigaments() ) {
-			if ( lig->ActsOnDof( *activeDof ) ) {
-				auto len_str = lig->GetName() + ".length_norm";
-				auto mom_str = lig->GetName() + ".moment_arm";
-				auto norm_factor = lig->GetRestingLength() / step.rad_value();
-				for ( int i = 0; i < storage.GetFrameCount(); ++i ) {
-					int i0 = std::max( 0, i - 1 ), i1 = std::min( (int)storage.GetFrameCount() - 1, i + 1 );
-					auto dl = storage.GetFrame( i1 )[len_str] - storage.GetFrame( i0 )[len_str];
-					auto moment_arm = norm_factor * -dl / ( i1 - i0 );
-					auto& frame = storage.GetFrame( i );
-					frame[mom_str] = moment_arm;
-					if ( ligamentDetail )
-						frame[lig->GetName() + ".moment"] = moment_arm * frame[lig->GetName() + ".force"];
-				}
-			}
-		}
+		auto r = ComputeMuscleAnalysis( model, *activeDof, storage, muscleDetail, ligamentDetail );
 
 		storageModel.setStorage( &storage );
 		view->reloadData();
@@ -149,63 +214,4 @@ namespace scone
 		dofReload->setDisabled( !enable );
 	}
 
-	void MuscleAnalysis::StoreMuscleData( Storage<Real>::Frame& frame, const Muscle& mus, const Dof& dof ) const
-	{
-		const auto& model = mus.GetModel();
-		const auto& name = mus.GetName();
-
-		if ( muscleDetail ) {
-			frame[name + ".fiber_length"] = mus.GetFiberLength();
-			frame[name + ".tendon_length"] = mus.GetTendonLength();
-			frame[name + ".mtu_length"] = mus.GetLength();
-			frame[name + ".mtu_force"] = mus.GetForce();
-		}
-
-		// moment arms
-		bool all_moment_arms = false; // this is not always correct (e.g. deltoid), figure out why
-		frame[name + ".moment_arm"] = mus.GetMomentArm( dof ); // will be recalculated later
-		if ( muscleDetail )
-			frame[name + ".mtu_moment"] = mus.GetMoment( dof ); // will be recalculated later
-		if ( all_moment_arms ) {
-			for ( auto* d : mus.GetDofs() )
-				frame[name + "." + d->GetName() + ".moment_arm"] = mus.GetMomentArm( *d );
-		}
-
-		// tendon / mtu properties
-		frame[name + ".fiber_length_norm"] = mus.GetNormalizedFiberLength();
-		frame[name + ".tendon_length_norm"] = mus.GetNormalizedTendonLength() - 1;
-		frame[name + ".mtu_length_norm"] = mus.GetLength() / ( mus.GetOptimalFiberLength() + mus.GetTendonSlackLength() );
-		frame[name + ".mtu_force_norm"] = mus.GetNormalizedForce();
-
-		// fiber properties
-		frame[name + ".activation"] = mus.GetActivation();
-		frame[name + ".cos_pennation_angle"] = mus.GetCosPennationAngle();
-		frame[name + ".force_length_multiplier"] = mus.GetActiveForceLengthMultipler();
-	}
-
-	void MuscleAnalysis::StoreLigamentData( Storage<Real>::Frame& frame, const Ligament& lig, const Dof& dof ) const
-	{
-		const auto& model = lig.GetModel();
-		const auto& name = lig.GetName();
-
-		if ( ligamentDetail ) {
-			frame[name + ".length"] = lig.GetLength();
-			frame[name + ".force"] = lig.GetForce();
-		}
-
-		// moment arms
-		bool all_moment_arms = false; // this is not always correct (e.g. deltoid), figure out why
-		frame[name + ".moment_arm"] = lig.GetMomentArm( dof ); // will be recalculated later
-		if ( ligamentDetail )
-			frame[name + ".moment"] = lig.GetMoment( dof ); // will be recalculated later
-		if ( all_moment_arms ) {
-			for ( auto* d : lig.GetDofs() )
-				frame[name + "." + d->GetName() + ".moment_arm"] = lig.GetMomentArm( *d );
-		}
-
-		// lengths
-		frame[name + ".length_norm"] = lig.GetNormalizedLength();
-		frame[name + ".force_norm"] = lig.GetNormalizedForce();
-	}
-
 }
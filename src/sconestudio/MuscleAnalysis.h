@@ -5,11 +5,15 @@
 #include <QPushButton>
 #include <QString>
 #include "scone/core/Storage.h"
+#include "scone/core/Angle.h"
 #include "SconeStorageDataModel.h"
 #include "QDataAnalysisView.h"
 
 namespace scone
 {
+	/// Sweep a dof through its range and store muscle and ligament properties, with the angle in degrees as time
+	BoundsDeg ComputeMuscleAnalysis( Model& model, Dof& dof, Storage<>& storage, bool muscleDetail, bool ligamentDetail );
+
 	class MuscleAnalysis : public QWidget
 	{
 		Q_OBJECT
@@ -31,9 +35,6 @@ namespace scone
 		void refresh() { if ( !dofName.isEmpty() ) dofChanged( dofName ); }
 
 	private:
-		void StoreMuscleData( Storage<Real>::Frame& frame, const Muscle& mus, const Dof& dof ) const;
-		void StoreLigamentData( Storage<Real>::Frame& frame, const Ligament& lig, const Dof& dof ) const;
-
 		scone::Storage<> storage;
 		SconeStorageDataModel storageModel;
 		QComboBox* dofSelect;
@@ -0,0 +1,233 @@
+/*
+** OffscreenRenderer.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "OffscreenRenderer.h"
+
+#include <osg/GL>
+#include <osg/GraphicsContext>
+#include <osgViewer/Viewer>
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+#include "scone/model/State.h"
+#include "scone/model/Body.h"
+#include "scone/core/Angle.h"
+#include "vis/scene.h"
+#include "vis-osg/osg_object_manager.h"
+#include "vis-osg/osg_tools.h"
+#include "BatchEvaluation.h"
+#include "ModelVis.h"
+#include "qt_convert.h"
+
+namespace scone
+{
+	struct OffscreenCaptureCallback : public osg::Camera::DrawCallback
+	{
+		OffscreenCaptureCallback( OffscreenRenderer& r ) : renderer( r ), frame( -1 ) {}
+		virtual void operator()( osg::RenderInfo& renderInfo ) const override { renderer.submitFrame( frame ); }
+		OffscreenRenderer& renderer;
+		int frame;
+	};
+
+	std::mutex& OffscreenRenderer::visMutex()
+	{
+		static std::mutex vis_mutex;
+		return vis_mutex;
+	}
+
+	OffscreenRenderer::OffscreenRenderer( const xo::path& file, Storage<> data, const OffscreenRenderSettings& s, VideoEncoder& encoder ) :
+		file_( file ),
+		data_( std::move( data ) ),
+		settings_( s ),
+		encoder_( encoder ),
+		next_frame_( 0 ),
+		frames_rendered_( 0 ),
+		abort_( false ),
+		next_submit_frame_( 0 ),
+		finished_threads_( 0 )
+	{
+		auto num_threads = s.threads > 0 ? s.threads : int( std::max( 1u, std::thread::hardware_concurrency() ) );
+		num_threads = std::max( 1, std::min( num_threads, s.frame_count ) );
+		for ( int i = 0; i < num_threads; ++i )
+			threads_.emplace_back( &OffscreenRenderer::threadFunc, this );
+	}
+
+	OffscreenRenderer::~OffscreenRenderer()
+	{
+		abort();
+		for ( auto& t : threads_ )
+			t.join();
+	}
+
+	void OffscreenRenderer::abort()
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			abort_ = true;
+		}
+		cv_.notify_all();
+	}
+
+	bool OffscreenRenderer::waitForFinished( int msecs )
+	{
+		std::unique_lock lock( mutex_ );
+		return cv_.wait_for( lock, std::chrono::milliseconds( msecs ), [&]() { return finished_threads_ == threads_.size(); } );
+	}
+
+	QString OffscreenRenderer::errorString() const
+	{
+		std::scoped_lock lock( mutex_ );
+		return error_;
+	}
+
+	void OffscreenRenderer::setError( const QString& msg )
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			if ( error_.isEmpty() )
+				error_ = msg;
+			abort_ = true;
+		}
+		cv_.notify_all();
+	}
+
+	void OffscreenRenderer::submitFrame( int frame )
+	{
+		// frames are rendered in parallel, but must be submitted in order
+		std::unique_lock lock( mutex_ );
+		cv_.wait( lock, [&]() { return next_submit_frame_ == frame || abort_; } );
+		if ( abort_ )
+			return;
+		lock.unlock();
+
+		if ( auto* data = encoder_.acquireFrame() ) {
+			glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+			glReadPixels( 0, 0, settings_.width, settings_.height, GL_RGB, GL_UNSIGNED_BYTE, data );
+			encoder_.submitFrame();
+		}
+		else return setError( "Video encoding has stopped: " + encoder_.errorString() );
+
+		lock.lock();
+		++next_submit_frame_;
+		lock.unlock();
+		cv_.notify_all();
+	}
+
+	void OffscreenRenderer::threadFunc()
+	{
+		const auto& s = settings_;
+		try
+		{
+			// each thread has its own model instance, because models are not thread-safe
+			auto [optimizer, model] = CreateOptimizerAndModel( file_ );
+			auto state = model->GetState();
+			std::vector<index_t> state_data_index( state.GetSize() );
+			for ( index_t i = 0; i < state.GetSize(); ++i ) {
+				state_data_index[ i ] = data_.TryGetChannelIndex( state.GetName( i ) );
+				SCONE_ERROR_IF( state_data_index[ i ] == NoIndex, "Could not find state channel " + state.GetName( i ) );
+			}
+			auto set_state = [&]( double t ) {
+				const auto& f = data_.GetInterpolatedFrame( t );
+				for ( index_t i = 0; i < state.GetSize(); ++i )
+					state[ i ] = f.value( state_data_index[ i ] );
+				model->SetState( state, t );
+			};
+
+			// the camera follows the horizontal movement of the model, relative to the reference time
+			const Body* follow_body = nullptr;
+			if ( !s.follow_body.empty() ) {
+				if ( auto it = TryFindByName( model->GetBodies(), s.follow_body ); it != model->GetBodies().end() )
+					follow_body = *it;
+				else log::warning( "Could not find follow body: ", s.follow_body );
+			}
+			auto follow_point = [&]() { return follow_body ? follow_body->GetComPos() : model->GetComPos(); };
+			set_state( s.reference_time );
+			const auto reference_point = follow_point();
+			const osg::Vec3d reference_focus( reference_point.x, 0.0, reference_point.z );
+			const bool follow = !s.view_options.get<ViewOption::StaticCamera>();
+			const auto base_view = s.view_relative_to_reference ? osg::Matrixd::translate( -reference_focus ) * s.view_matrix : s.view_matrix;
+
+			osg::ref_ptr<osgViewer::Viewer> viewer = new osgViewer::Viewer;
+			osg::ref_ptr<OffscreenCaptureCallback> capture = new OffscreenCaptureCallback( *this );
+			std::unique_ptr<vis::scene> scene;
+			std::unique_ptr<ModelVis> vis;
+			{
+				// contexts and scenes are created one at a time
+				std::scoped_lock vis_lock( visMutex() );
+				osg::ref_ptr<osg::GraphicsContext::Traits> traits = new osg::GraphicsContext::Traits;
+				traits->width = s.width;
+				traits->height = s.height;
+				traits->pbuffer = true;
+				traits->doubleBuffer = false;
+				traits->readDISPLAY();
+				traits->setUndefinedScreenDetailsToDefaultScreen();
+				osg::ref_ptr<osg::GraphicsContext> gc = osg::GraphicsContext::createGraphicsContext( traits.get() );
+				SCONE_ERROR_IF( !gc || !gc->valid(), "Could not create offscreen graphics context" );
+
+				auto* camera = viewer->getCamera();
+				camera->setGraphicsContext( gc.get() );
+				camera->setViewport( new osg::Viewport( 0, 0, s.width, s.height ) );
+				camera->setProjectionMatrix( s.projection_matrix );
+				camera->setClearColor( s.clear_color );
+				camera->setDrawBuffer( GL_FRONT );
+				camera->setReadBuffer( GL_FRONT );
+				camera->setFinalDrawCallback( capture.get() );
+				viewer->setThreadingModel( osgViewer::ViewerBase::SingleThreaded );
+				viewer->setCameraManipulator( nullptr );
+
+				scene = std::make_unique<vis::scene>( true, s.ambient_intensity );
+				vis = std::make_unique<ModelVis>( *model, *scene, s.view_options );
+				viewer->setSceneData( &vis::osg_group( scene->node_id() ) );
+				viewer->realize();
+			}
+
+			while ( !abort_ )
+			{
+				int frame = next_frame_++;
+				if ( frame >= s.frame_count )
+					break;
+
+				auto t = frame * s.time_step;
+				set_state( t );
+				{
+					// ModelVis::Update can create new vis objects
+					std::scoped_lock vis_lock( visMutex() );
+					vis->Update( *model );
+				}
+
+				// orbit around the reference focus, then move along with the follow point
+				osg::Vec3d offset;
+				if ( follow ) {
+					auto d = follow_point() - reference_point;
+					offset.set( d.x, 0.0, d.z );
+				}
+				auto orbit_angle = Degree( s.orbit_speed * ( t - s.reference_time ) );
+				auto view = osg::Matrixd::translate( -offset - reference_focus )
+					* osg::Matrixd::rotate( Radian( orbit_angle ).value, osg::Vec3d( 0, 1, 0 ) )
+					* osg::Matrixd::translate( reference_focus ) * base_view;
+				viewer->getCamera()->setViewMatrix( view );
+				capture->frame = frame;
+				viewer->frame( t );
+				++frames_rendered_;
+			}
+
+			std::scoped_lock vis_lock( visMutex() );
+			vis.reset();
+			scene.reset();
+		}
+		catch ( const std::exception& e )
+		{
+			setError( QString( "Error rendering " ) + to_qt( file_.filename() ) + ": " + e.what() );
+		}
+
+		{
+			std::scoped_lock lock( mutex_ );
+			++finished_threads_;
+		}
+		cv_.notify_all();
+	}
+}
@@ -0,0 +1,84 @@
+/*
+** OffscreenRenderer.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QString>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <osg/Matrixd>
+#include <osg/Vec4>
+#include "scone/core/Storage.h"
+#include "scone/core/types.h"
+#include "xo/filesystem/path.h"
+#include "ViewOptions.h"
+#include "VideoEncoder.h"
+
+namespace scone
+{
+	struct OffscreenRenderSettings {
+		int width = 1024;
+		int height = 768;
+		int frame_count = 0;
+		double time_step = 1.0 / 30; // simulation time between frames
+		double reference_time = 0.0; // time at which the model is at the focus of view_matrix
+		ViewOptions view_options;
+		osg::Matrixd view_matrix;
+		bool view_relative_to_reference = false; // view_matrix is relative to the horizontal follow point at reference_time
+		String follow_body; // body followed by the camera, empty to follow the model center of mass
+		double orbit_speed = 0.0; // camera rotation around the vertical axis, in degrees per second simulation time
+		osg::Matrixd projection_matrix;
+		osg::Vec4 clear_color;
+		float ambient_intensity = 1.0f;
+		int threads = 0; // 0 = hardware concurrency
+	};
+
+	/// Renders the frames of a finished result into a VideoEncoder, using offscreen contexts in multiple threads.
+	/// Each thread creates its own model and scene from the scenario, frames are submitted to the encoder in order.
+	/// The renderer keeps its own copy of the data, so the source may change or be destroyed while rendering.
+	class OffscreenRenderer
+	{
+	public:
+		OffscreenRenderer( const xo::path& file, Storage<> data, const OffscreenRenderSettings& s, VideoEncoder& encoder );
+		~OffscreenRenderer();
+
+		void abort();
+		bool waitForFinished( int msecs );
+		int framesRendered() const { return frames_rendered_; }
+		QString errorString() const;
+
+		/// called from the final draw callback of each thread, waits for its turn and reads back the frame
+		void submitFrame( int frame );
+
+		/// the vis object manager is shared by all scenes and is not thread-safe, this lock is shared
+		/// by all renderers and must be held when creating or updating scenes while rendering
+		static std::mutex& visMutex();
+
+	private:
+		void threadFunc();
+		void setError( const QString& msg );
+
+		xo::path file_;
+		const Storage<> data_;
+		OffscreenRenderSettings settings_;
+		VideoEncoder& encoder_;
+
+		std::atomic<int> next_frame_;
+		std::atomic<int> frames_rendered_;
+		std::atomic<bool> abort_;
+		int next_submit_frame_;
+		size_t finished_threads_;
+		QString error_;
+		mutable std::mutex mutex_;
+		std::condition_variable cv_;
+		std::vector<std::thread> threads_;
+	};
+}
@@ -0,0 +1,207 @@
+/*
+** ProcessPool.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "ProcessPool.h"
+
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <thread>
+#include "scone/core/Log.h"
+#include "StudioSettings.h"
+#ifdef _MSC_VER
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace scone
+{
+	// CPU time (user + kernel) in seconds of a running process, or -1 if unavailable
+	double getProcessCpuTime( qint64 pid )
+	{
+#if defined(_MSC_VER)
+		double result = -1.0;
+		if ( HANDLE h = OpenProcess( PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD( pid ) ) ) {
+			FILETIME creation, exit, kernel, user;
+			if ( GetProcessTimes( h, &creation, &exit, &kernel, &user ) ) {
+				auto to_sec = []( const FILETIME& ft ) { return 1e-7 * ( ( quint64( ft.dwHighDateTime ) << 32 ) | ft.dwLowDateTime ); };
+				result = to_sec( kernel ) + to_sec( user );
+			}
+			CloseHandle( h );
+		}
+		return result;
+#elif defined(__linux__)
+		// utime and stime are fields 14 and 15, the process name in field 2 can contain spaces
+		QFile file( QString( "/proc/%1/stat" ).arg( pid ) );
+		if ( !file.open( QIODevice::ReadOnly ) )
+			return -1.0;
+		auto data = file.readAll();
+		auto fields = data.mid( data.lastIndexOf( ')' ) + 2 ).split( ' ' );
+		if ( fields.size() < 13 )
+			return -1.0;
+		return double( fields[ 11 ].toLongLong() + fields[ 12 ].toLongLong() ) / sysconf( _SC_CLK_TCK );
+#else
+		return -1.0;
+#endif
+	}
+
+	// available physical memory in MB, or 0 if unknown
+	qint64 getAvailableMemoryMB()
+	{
+#if defined(_MSC_VER)
+		MEMORYSTATUSEX status;
+		status.dwLength = sizeof( status );
+		return GlobalMemoryStatusEx( &status ) ? qint64( status.ullAvailPhys / ( 1024 * 1024 ) ) : 0;
+#elif defined(__linux__)
+		QFile file( "/proc/meminfo" );
+		if ( file.open( QIODevice::ReadOnly | QIODevice::Text ) ) {
+			QTextStream str( &file );
+			for ( auto line = str.readLine(); !line.isNull(); line = str.readLine() )
+				if ( line.startsWith( "MemAvailable:" ) )
+					return line.section( ' ', 1, 1, QString::SectionSkipEmpty ).toLongLong() / 1024;
+		}
+		return 0;
+#else
+		return 0;
+#endif
+	}
+
+	// interval at which the CPU time of active processes is sampled, in milliseconds
+	constexpr int cpu_time_sample_interval = 500;
+
+	ProcessPool::ProcessPool( QObject* parent ) :
+		QObject( parent )
+	{
+		connect( &sample_timer_, &QTimer::timeout, this, [this]() { sampleCpuTime(); emit statusChanged(); } );
+	}
+
+	ProcessPool::~ProcessPool()
+	{
+		queued_.clear();
+		for ( auto& job : active_ ) {
+			job->process->disconnect( this );
+			job->process->kill();
+			job->process->waitForFinished();
+		}
+	}
+
+	void ProcessPool::enqueue( QProcessPtr process, const QString& logFile )
+	{
+		auto job = std::make_unique<Job>();
+		job->process = std::move( process );
+		job->process->setParent( nullptr );
+		job->log_file = logFile;
+		queued_.push_back( std::move( job ) );
+		startQueued();
+	}
+
+	void ProcessPool::clearQueue()
+	{
+		queued_.clear();
+		emit statusChanged();
+	}
+
+	size_t ProcessPool::maxConcurrentCount() const
+	{
+		const auto& gym_settings = GetStudioSettingsSnapshot().sconegym;
+		auto max_count = gym_settings.max_concurrent_evaluations;
+		if ( max_count == 0 )
+			max_count = std::max( 1u, std::thread::hardware_concurrency() / 2 );
+
+		// available memory already excludes the memory used by active processes
+		auto memory_per_process = gym_settings.memory_per_evaluation;
+		if ( auto available = getAvailableMemoryMB(); memory_per_process > 0 && available > 0 )
+			max_count = std::min( max_count, std::max<size_t>( 1, active_.size() + available / memory_per_process ) );
+
+		return max_count;
+	}
+
+	QString ProcessPool::statusText() const
+	{
+		QStringList lines;
+		for ( auto& job : active_ ) {
+			lines.push_back( QString( "%1: %2s wall, %3s CPU" ).arg( QFileInfo( job->log_file ).completeBaseName() )
+				.arg( job->wall_time.elapsed() / 1000 ).arg( job->cpu_time, 0, 'f', 1 ) );
+		}
+		return lines.join( '\n' );
+	}
+
+	void ProcessPool::startQueued()
+	{
+		for ( auto max_count = maxConcurrentCount(); active_.size() < max_count && !queued_.empty(); )
+		{
+			auto job = std::move( queued_.front() );
+			queued_.pop_front();
+
+			auto* p = job->process.get();
+			job->log = std::make_unique<QFile>( job->log_file );
+			if ( !job->log->open( QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate ) )
+				log::warning( "Could not open log file ", job->log_file.toStdString() );
+
+			connect( p, &QProcess::readyRead, this, [this, p]() { if ( auto* j = findJob( p ) ) readOutput( *j ); } );
+			connect( p, QOverload<int, QProcess::ExitStatus>::of( &QProcess::finished ), this, [this, p]() { finished( p ); } );
+			connect( p, &QProcess::errorOccurred, this, [this, p]( QProcess::ProcessError e ) {
+				if ( e == QProcess::FailedToStart ) {
+					log::error( "Could not start process: ", p->program().toStdString(), " ", p->arguments().join( ' ' ).toStdString() );
+					finished( p );
+				} } );
+
+			job->wall_time.start();
+			active_.push_back( std::move( job ) );
+			p->start();
+		}
+		if ( !active_.empty() && !sample_timer_.isActive() )
+			sample_timer_.start( cpu_time_sample_interval );
+		emit statusChanged();
+	}
+
+	void ProcessPool::readOutput( Job& job )
+	{
+		// output is written directly to the log file, so memory use does not grow with output size
+		auto data = job.process->readAll();
+		if ( job.log->isOpen() )
+			job.log->write( data );
+	}
+
+	void ProcessPool::sampleCpuTime()
+	{
+		for ( auto& job : active_ )
+			if ( auto pid = job->process->processId(); pid != 0 )
+				if ( auto t = getProcessCpuTime( pid ); t >= 0.0 )
+					job->cpu_time = t;
+	}
+
+	void ProcessPool::finished( QProcess* process )
+	{
+		auto it = std::find_if( active_.begin(), active_.end(), [process]( auto& j ) { return j->process.get() == process; } );
+		if ( it == active_.end() )
+			return;
+
+		// the process has already been reaped, so its CPU time is the last periodic sample
+		auto& job = **it;
+		readOutput( job );
+		job.log->close();
+		log::info( "Process finished with exit code ", process->exitCode(), " after ", job.wall_time.elapsed() / 1000.0,
+			"s (", job.cpu_time, "s CPU, sampled every ", cpu_time_sample_interval, "ms); output written to ", job.log_file.toStdString() );
+
+		// the process is deleted after its signal handlers are done
+		process->disconnect( this );
+		job.process.release()->deleteLater();
+		active_.erase( it );
+		if ( active_.empty() )
+			sample_timer_.stop();
+		startQueued();
+	}
+
+	ProcessPool::Job* ProcessPool::findJob( QProcess* process )
+	{
+		auto it = std::find_if( active_.begin(), active_.end(), [process]( auto& j ) { return j->process.get() == process; } );
+		return it != active_.end() ? it->get() : nullptr;
+	}
+}
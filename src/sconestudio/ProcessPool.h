@@ -0,0 +1,67 @@
+/*
+** ProcessPool.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <deque>
+#include <vector>
+#include <memory>
+#include "external_tools.h"
+
+namespace scone
+{
+	/// Runs external processes in first-in-first-out order, driven by QProcess signals.
+	/// The number of concurrent processes is limited by the number of cores and the available memory.
+	/// Output of each process is streamed to its own log file.
+	/// The CPU time of active processes is sampled periodically, statusChanged() is emitted after each sample.
+	class ProcessPool : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		ProcessPool( QObject* parent = nullptr );
+		virtual ~ProcessPool();
+
+		void enqueue( QProcessPtr process, const QString& logFile );
+		void clearQueue();
+
+		size_t activeCount() const { return active_.size(); }
+		size_t queuedCount() const { return queued_.size(); }
+		size_t maxConcurrentCount() const;
+
+		/// summary of active processes with their CPU time, one process per line
+		QString statusText() const;
+
+	signals:
+		void statusChanged();
+
+	private:
+		struct Job {
+			QProcessPtr process;
+			QString log_file;
+			std::unique_ptr<QFile> log;
+			QElapsedTimer wall_time;
+			double cpu_time = 0.0;
+		};
+
+		void startQueued();
+		void readOutput( Job& job );
+		void sampleCpuTime();
+		void finished( QProcess* process );
+		Job* findJob( QProcess* process );
+
+		std::vector<std::unique_ptr<Job>> active_;
+		std::deque<std::unique_ptr<Job>> queued_;
+		QTimer sample_timer_;
+	};
+}
@@ -18,6 +18,12 @@
 #include "StudioSettings.h"
 #include "xo/container/container_tools.h"
 #include "xo/serialization/prop_node_serializer_ini.h"
+#include "studio_profiler.h"
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QTimer>
+#include <QScreen>
+#include <QGuiApplication>
 #include <sstream>
 
 using namespace scone;
@@ -28,13 +34,19 @@ ProgressDockWidget::ProgressDockWidget( SconeStudio* s, std::unique_ptr<scone::O
 	state( StartingState ),
 	showCloseWarning( true ),
 	closeWhenFinished( false ),
+	isStopped( false ),
 	showPrediction( GetStudioSetting<bool>( "progress.show_prediction" ) ),
 	min_view_gens( 20 ),
 	view_first_gen( 0 ),
 	view_last_gen( min_view_gens ),
-	best_idx( -1 )
+	best_idx( -1 ),
+	tooltipDirty( false ),
+	replotPending( false ),
+	replotCount( 0 ),
+	skippedReplotCount( 0 )
 {
 	ui.setupUi( this );
+	ui.text->installEventFilter( this );
 
 	auto axisRectMargins = QMargins{ 0, 6, 3, 0 };
 	QFont tickLabelFont = ui.plot->font();
@@ -76,7 +88,7 @@ ProgressDockWidget::~ProgressDockWidget()
 {
 	if ( state != ClosedState )
 		log::critical( "Deleting Progress Dock that is not closed: ", getIdentifier().toStdString() );
-	else log::debug( "Closed optimization ", getIdentifier().toStdString() );
+	else log::debug( "Closed optimization ", getIdentifier().toStdString(), "; replots=", replotCount, " skipped=", skippedReplotCount );
 }
 
 void ProgressDockWidget::SetAxisScaleType( AxisScaleType ast, double log_base )
@@ -105,14 +117,7 @@ void ProgressDockWidget::fixRangeY()
 {
 	double upper = 0.0, lower = 0.0;
 	for ( auto& o : optimizations )
-	{
-		if ( view_first_gen < o.bestvec.size() )
-		{
-			auto bestminmax = std::minmax_element( o.bestvec.begin() + view_first_gen, o.bestvec.end() );
-			xo::set_if_smaller( lower, *bestminmax.first );
-			xo::set_if_bigger( upper, *bestminmax.second );
-		}
-	}
+		o.history.extendBestRange( view_first_gen, view_last_gen, lower, upper );
 	//log::info( "setting y-range to ", lower, " ", upper );
 	ui.plot->yAxis->setRange( lower, upper );
 }
@@ -128,9 +133,7 @@ void ProgressDockWidget::Optimization::Update( const PropNode& pn )
 	{
 		pn.try_get( cur_reg.offset(), "trend_offset" );
 		pn.try_get( cur_reg.slope(), "trend_slope" );
-		medvec.push_back( pn.get< double >( "step_median" ) );
-		bestvec.push_back( pn.get< double >( "step_best" ) );
-		genvec.push_back( cur_gen );
+		history.add( cur_gen, pn.get< double >( "step_best" ) );
 		if ( !pn.try_get( cur_pred, "predicted_fitness" ) )
 			cur_pred = cur_reg( float( cur_gen + window_size ) );
 	}
@@ -163,6 +166,7 @@ ProgressDockWidget::ProgressResult ProgressDockWidget::updateProgress()
 		return IsClosedResult;
 	}
 
+	bool needsReplot = false;
 	for ( auto messages = task_->getMessages(); !messages.empty(); messages.pop_front() )
 	{
 		const auto& pn = messages.front();
@@ -176,6 +180,7 @@ ProgressDockWidget::ProgressResult ProgressDockWidget::updateProgress()
 
 				new_opt.idx = idx;
 				new_opt.name = *id;
+				new_opt.history = ProgressHistory( GetStudioSettingsSnapshot().progress.full_resolution_generations );
 				new_opt.Update( pn );
 				new_opt.state = RunningState;
 				state = RunningState;
@@ -184,14 +189,14 @@ ProgressDockWidget::ProgressResult ProgressDockWidget::updateProgress()
 				QColor c = to_qt( xo::make_unique_color( idx ) );
 #ifdef SCONE_SHOW_TREND_LINES
 				ui.plot->addGraph();
-				ui.plot->graph( idx * 2 )->setPen( QPen( c, GetStudioSetting< float >( "progress.line_width" ) ) );
+				ui.plot->graph( idx * 2 )->setPen( QPen( c, GetStudioSettingsSnapshot().progress.line_width ) );
 				ui.plot->graph( idx * 2 )->setLineStyle( QCPGraph::lsLine );
 				ui.plot->addGraph();
 				ui.plot->graph( idx * 2 + 1 )->setPen( QPen( c.lighter(), 1, Qt::DashLine ) );
 				ui.plot->graph( idx * 2 + 1 )->setLineStyle( QCPGraph::lsLine );
 #else
 				ui.plot->addGraph();
-				ui.plot->graph( idx )->setPen( QPen( c, GetStudioSetting< float >( "progress.line_width" ) ) );
+				ui.plot->graph( idx )->setPen( QPen( c, GetStudioSettingsSnapshot().progress.line_width ) );
 				ui.plot->graph( idx )->setLineStyle( QCPGraph::lsLine );
 #endif
 				ui.plot->show();
@@ -243,8 +248,10 @@ ProgressDockWidget::ProgressResult ProgressDockWidget::updateProgress()
 			}
 		}
 
-		// always merge data into tooltip
+		// always merge data into tooltip, text is generated when the tooltip is shown
 		tooltipProps.merge( pn, true );
+		tooltipDirty = true;
+		needsReplot = true;
 	}
 
 	auto new_view_last_gen = view_last_gen;
@@ -257,15 +264,29 @@ ProgressDockWidget::ProgressResult ProgressDockWidget::updateProgress()
 
 			// update graphs
 #ifdef SCONE_SHOW_TREND_LINES
-			ui.plot->graph( idx * 2 )->setData( o.genvec, o.bestvec );
+			QVector< double > genvec, bestvec;
+			for ( int i = 0; i < o.history.plotPointCount(); ++i ) {
+				auto [gen, best] = o.history.plotPoint( i );
+				genvec.push_back( gen );
+				bestvec.push_back( best );
+			}
+			ui.plot->graph( idx * 2 )->setData( genvec, bestvec );
 			auto start_gen = std::max( 0, o.cur_gen - o.window_size );
 			ui.plot->graph( idx * 2 + 1 )->setData( QVector< double >{ start_gen, o.cur_gen }, QVector< double >{ o.cur_reg( start_gen ), o.cur_reg( float( o.cur_gen ) ); } );
 #else
+			// older points are aggregated once in a while, in which case the graph is rebuilt
 			auto* g = ui.plot->graph( idx );
-			for ( int i = g->data()->size(); i < o.genvec.size(); ++i )
-				g->addData( o.genvec[i], o.bestvec[i] );
-			if ( o.genvec.size() >= view_last_gen )
-				new_view_last_gen = o.genvec.size() - 1;
+			if ( o.plot_revision != o.history.revision() )
+			{
+				g->clearData();
+				o.plot_revision = o.history.revision();
+			}
+			for ( int i = g->data()->size(); i < o.history.plotPointCount(); ++i ) {
+				auto [gen, best] = o.history.plotPoint( i );
+				g->addData( gen, best );
+			}
+			if ( o.history.samples() >= view_last_gen )
+				new_view_last_gen = o.history.samples() - 1;
 #endif
 		}
 	}
@@ -278,18 +299,88 @@ ProgressDockWidget::ProgressResult ProgressDockWidget::updateProgress()
 		view_last_gen = new_view_last_gen;
 		ui.plot->xAxis->setRange( view_first_gen, view_last_gen );
 		fixRangeY();
+		needsReplot = true;
 	}
-	ui.plot->replot();
 
-	// #todo: use to_str instead
-	std::stringstream str;
-	xo::prop_node_serializer_ini( tooltipProps ).write_stream( str );
-	tooltipText = to_qt( str.str() );
-	ui.text->setToolTip( tooltipText );
+	if ( needsReplot )
+		requestReplot();
 
 	return OkResult;
 }
 
+void ProgressDockWidget::requestReplot()
+{
+	// coalesce replot requests to at most one per display refresh
+	if ( replotPending )
+	{
+		STUDIO_PROFILE_SCOPE( "ProgressDockWidget::skippedReplot" );
+		++skippedReplotCount;
+		return;
+	}
+
+	replotPending = true;
+	auto* screen = QGuiApplication::primaryScreen();
+	auto refreshRate = screen ? screen->refreshRate() : 60.0;
+	QTimer::singleShot( std::max( 1, int( 1000 / refreshRate ) ), this, &ProgressDockWidget::replot );
+}
+
+void ProgressDockWidget::replot()
+{
+	if ( !replotPending )
+		return;
+
+	// hidden docks (e.g. in a tab) are replotted when shown
+	if ( !isVisible() )
+	{
+		STUDIO_PROFILE_SCOPE( "ProgressDockWidget::skippedReplot" );
+		++skippedReplotCount;
+		return;
+	}
+
+	STUDIO_PROFILE_FUNCTION;
+	replotPending = false;
+	++replotCount;
+	ui.plot->replot();
+}
+
+void ProgressDockWidget::showEvent( QShowEvent* e )
+{
+	QDockWidget::showEvent( e );
+	if ( replotPending )
+		QTimer::singleShot( 0, this, &ProgressDockWidget::replot );
+}
+
+bool ProgressDockWidget::eventFilter( QObject* obj, QEvent* e )
+{
+	if ( obj == ui.text && e->type() == QEvent::ToolTip )
+	{
+		if ( tooltipDirty )
+		{
+			// #todo: use to_str instead
+			std::stringstream str;
+			xo::prop_node_serializer_ini( tooltipProps ).write_stream( str );
+			tooltipText = to_qt( str.str() );
+			tooltipDirty = false;
+		}
+		auto* he = static_cast<QHelpEvent*>( e );
+		if ( !tooltipText.isEmpty() )
+			QToolTip::showText( he->globalPos(), tooltipText, ui.text );
+		else QToolTip::hideText();
+		return true;
+	}
+	return QDockWidget::eventFilter( obj, e );
+}
+
+void ProgressDockWidget::stopOptimization()
+{
+	// interrupt without closing, the optimizer will report it has finished
+	if ( isRunning() && task_->interrupt() )
+	{
+		isStopped = true;
+		showCloseWarning = false;
+	}
+}
+
 bool ProgressDockWidget::readyForDestruction() const
 {
 	return state == ClosedState;
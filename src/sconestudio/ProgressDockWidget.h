@@ -17,6 +17,7 @@
 #include "scone/core/types.h"
 #include "qt_convert.h"
 #include "OptimizerTask.h"
+#include "ProgressHistory.h"
 
 using scone::String;
 using scone::PropNode;
@@ -38,6 +39,8 @@ public:
 	bool readyForDestruction() const;
 	bool canCloseWithoutWarning() const;
 	void disableCloseWarning() { showCloseWarning = false; }
+	bool isRunning() const { return ( state == StartingState || state == RunningState ) && !closeWhenFinished; }
+	void stopOptimization();
 
 	enum AxisScaleType { Linear, Logarithmic };
 	void SetAxisScaleType( AxisScaleType ast, double log_base = 2.0 );
@@ -49,6 +52,11 @@ public:
 	String message;
 	PropNode tooltipProps;
 	QString tooltipText;
+	bool tooltipDirty;
+
+	bool replotPending;
+	int replotCount;
+	int skippedReplotCount;
 
 	struct Optimization
 	{
@@ -68,9 +76,8 @@ public:
 
 		double duration;
 
-		QVector< double > bestvec;
-		QVector< double > medvec;
-		QVector< double > genvec;
+		scone::ProgressHistory history;
+		int plot_revision = 0;
 
 		void Update( const PropNode& pn );
 		bool has_update_flag = false;
@@ -78,6 +85,7 @@ public:
 
 	bool showCloseWarning;
 	bool closeWhenFinished;
+	bool isStopped;
 	const bool showPrediction;
 
 	int min_view_gens;
@@ -93,10 +101,14 @@ public:
 public slots:
 	void rangeChanged( const QCPRange& newRange, const QCPRange& oldRange );
 	void fixRangeY();
+	void replot();
 
 protected:
 	virtual void closeEvent( QCloseEvent* ) override;
+	virtual void showEvent( QShowEvent* ) override;
+	virtual bool eventFilter( QObject* obj, QEvent* e ) override;
 
 private:
 	void updateText();
+	void requestReplot();
 };
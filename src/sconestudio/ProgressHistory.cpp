@@ -0,0 +1,107 @@
+/*
+** ProgressHistory.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "ProgressHistory.h"
+#include <algorithm>
+
+namespace scone
+{
+	ProgressHistory::ProgressHistory( int recent_size, int max_blocks ) :
+		recent_size_( std::max( recent_size, 1 ) ),
+		max_blocks_( std::max( max_blocks, 2 ) ),
+		block_size_( 4 ),
+		samples_( 0 ),
+		last_gen_( -1 ),
+		revision_( 0 )
+	{}
+
+	void ProgressHistory::add( int gen, double best )
+	{
+		recent_.push_back( Sample{ gen, best } );
+		last_gen_ = gen;
+		++samples_;
+
+		// aggregate in chunks of recent_size_, so that plot points are rebuilt only once per chunk
+		if ( int( recent_.size() ) >= 2 * recent_size_ )
+			aggregate();
+	}
+
+	std::pair<double, double> ProgressHistory::plotPoint( int idx ) const
+	{
+		const auto block_points = 2 * int( blocks_.size() );
+		if ( idx < block_points )
+		{
+			// each block is drawn as its min and max samples, in order of generation
+			const auto& b = blocks_[ idx / 2 ];
+			const auto& first = b.min_best.gen <= b.max_best.gen ? b.min_best : b.max_best;
+			const auto& second = b.min_best.gen <= b.max_best.gen ? b.max_best : b.min_best;
+			const auto& s = ( idx % 2 == 0 ) ? first : second;
+			return { double( s.gen ), s.best };
+		}
+		const auto& s = recent_[ idx - block_points ];
+		return { double( s.gen ), s.best };
+	}
+
+	void ProgressHistory::extendBestRange( int first_gen, int last_gen, double& lower, double& upper ) const
+	{
+		auto bit = std::lower_bound( blocks_.begin(), blocks_.end(), first_gen, []( const Block& b, int g ) { return b.last_gen < g; } );
+		for ( ; bit != blocks_.end() && bit->first_gen <= last_gen; ++bit )
+		{
+			lower = std::min( lower, bit->min_best.best );
+			upper = std::max( upper, bit->max_best.best );
+		}
+
+		auto sit = std::lower_bound( recent_.begin(), recent_.end(), first_gen, []( const Sample& s, int g ) { return s.gen < g; } );
+		for ( ; sit != recent_.end() && sit->gen <= last_gen; ++sit )
+		{
+			lower = std::min( lower, sit->best );
+			upper = std::max( upper, sit->best );
+		}
+	}
+
+	void ProgressHistory::aggregate()
+	{
+		// move the oldest recent_size_ samples into blocks of block_size_ samples
+		auto count = int( recent_.size() ) - recent_size_;
+		for ( int i = 0; i < count; i += block_size_ )
+		{
+			Block b{ recent_.front().gen, recent_.front().gen, recent_.front(), recent_.front() };
+			for ( int j = 0; j < block_size_ && i + j < count; ++j )
+			{
+				const auto& s = recent_.front();
+				b.last_gen = s.gen;
+				if ( s.best < b.min_best.best )
+					b.min_best = s;
+				if ( s.best > b.max_best.best )
+					b.max_best = s;
+				recent_.pop_front();
+			}
+			blocks_.push_back( b );
+		}
+
+		// halve the resolution of the blocks when there are too many
+		while ( int( blocks_.size() ) > max_blocks_ )
+		{
+			std::vector<Block> merged;
+			merged.reserve( blocks_.size() / 2 + 1 );
+			for ( size_t i = 0; i < blocks_.size(); i += 2 )
+				merged.push_back( i + 1 < blocks_.size() ? merge( blocks_[ i ], blocks_[ i + 1 ] ) : blocks_[ i ] );
+			blocks_.swap( merged );
+			block_size_ *= 2;
+		}
+
+		++revision_;
+	}
+
+	ProgressHistory::Block ProgressHistory::merge( const Block& a, const Block& b )
+	{
+		return Block{ a.first_gen, b.last_gen,
+			a.min_best.best <= b.min_best.best ? a.min_best : b.min_best,
+			a.max_best.best >= b.max_best.best ? a.max_best : b.max_best };
+	}
+}
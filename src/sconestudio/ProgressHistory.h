@@ -0,0 +1,66 @@
+/*
+** ProgressHistory.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <utility>
+
+namespace scone
+{
+	/// Fitness history of a single optimization, used for progress plots.
+	/// The most recent generations are kept at full resolution, older generations are aggregated
+	/// into blocks that keep their min / max values, so memory and plot size stay bounded.
+	/// The full-resolution history is written by the optimizer to history.txt.
+	class ProgressHistory
+	{
+	public:
+		ProgressHistory( int recent_size = 1000, int max_blocks = 1000 );
+
+		void add( int gen, double best );
+
+		bool empty() const { return samples_ == 0; }
+		int samples() const { return samples_; }
+		int lastGen() const { return last_gen_; }
+
+		/// changes each time older samples are aggregated, after which plot points must be rebuilt
+		int revision() const { return revision_; }
+
+		/// plot points, ordered by generation; new samples are always appended at the end
+		int plotPointCount() const { return 2 * int( blocks_.size() ) + int( recent_.size() ); }
+		std::pair<double, double> plotPoint( int idx ) const;
+
+		/// extend [ lower, upper ] with the best values in generations [ first_gen, last_gen ], in O( visible points )
+		void extendBestRange( int first_gen, int last_gen, double& lower, double& upper ) const;
+
+	private:
+		struct Sample {
+			int gen;
+			double best;
+		};
+		struct Block {
+			int first_gen;
+			int last_gen;
+			Sample min_best;
+			Sample max_best;
+		};
+
+		void aggregate();
+		static Block merge( const Block& a, const Block& b );
+
+		std::deque<Sample> recent_;
+		std::vector<Block> blocks_;
+		int recent_size_;
+		int max_blocks_;
+		int block_size_;
+		int samples_;
+		int last_gen_;
+		int revision_;
+	};
+}
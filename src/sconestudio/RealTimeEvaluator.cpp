@@ -0,0 +1,114 @@
+/*
+** RealTimeEvaluator.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "RealTimeEvaluator.h"
+
+#include <algorithm>
+#include <chrono>
+#include "scone/core/Log.h"
+#include "xo/time/timer.h"
+
+namespace scone
+{
+	// maximum simulation time per lock, keeps the GUI thread responsive
+	constexpr TimeInSeconds evaluation_chunk = 0.005;
+
+	// interval at which the real-time factor is measured
+	constexpr double real_time_factor_window = 0.5;
+
+	RealTimeEvaluator::RealTimeEvaluator( StudioModel& model, double slow_motion_factor, TimeInSeconds max_step ) :
+		model_( model ),
+		max_step_( max_step ),
+		slow_motion_factor_( slow_motion_factor ),
+		sim_time_( model.GetTime() ),
+		lag_( 0.0 ),
+		real_time_factor_( 0.0 ),
+		clamped_steps_( 0 ),
+		stop_( false ),
+		finished_( false )
+	{
+		thread_ = std::thread( &RealTimeEvaluator::threadFunc, this );
+	}
+
+	RealTimeEvaluator::~RealTimeEvaluator()
+	{
+		stop();
+	}
+
+	void RealTimeEvaluator::stop()
+	{
+		stop_ = true;
+		if ( thread_.joinable() )
+			thread_.join();
+	}
+
+	void RealTimeEvaluator::threadFunc()
+	{
+		try
+		{
+			// paced time is base_sim_time + slomo * ( wall_time - base_wall_time )
+			xo::timer timer;
+			double slomo = slow_motion_factor_;
+			double base_wall_time = 0.0;
+			TimeInSeconds base_sim_time = sim_time_;
+			double window_wall_time = 0.0;
+			TimeInSeconds window_sim_time = sim_time_;
+
+			while ( !stop_ )
+			{
+				auto wall_time = timer().secondsd();
+				if ( slomo != slow_motion_factor_ ) {
+					// continue from the current paced time
+					base_sim_time += slomo * ( wall_time - base_wall_time );
+					base_wall_time = wall_time;
+					slomo = slow_motion_factor_;
+				}
+
+				TimeInSeconds sim_time = sim_time_;
+				auto target_time = base_sim_time + slomo * ( wall_time - base_wall_time );
+				if ( target_time - sim_time > max_step_ ) {
+					// simulation can't keep up, restart pacing instead of trying to catch up
+					target_time = sim_time + max_step_;
+					base_sim_time = target_time;
+					base_wall_time = wall_time;
+					++clamped_steps_;
+				}
+
+				if ( target_time <= sim_time ) {
+					std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+					continue;
+				}
+
+				while ( sim_time < target_time && !stop_ )
+				{
+					std::scoped_lock lock( model_mutex_ );
+					model_.AdvanceSimulationTo( std::min( sim_time + evaluation_chunk, target_time ) );
+					if ( model_.GetModel().HasSimulationEnded() )
+						stop_ = true; // the simulation is finalized by the owner
+					auto prev_sim_time = sim_time;
+					sim_time_ = sim_time = model_.GetTime();
+					if ( sim_time <= prev_sim_time )
+						break; // target is within the simulation step size
+				}
+
+				wall_time = timer().secondsd();
+				lag_ = std::max( 0.0, base_sim_time + slomo * ( wall_time - base_wall_time ) - sim_time );
+				if ( wall_time - window_wall_time >= real_time_factor_window ) {
+					real_time_factor_ = ( sim_time - window_sim_time ) / ( wall_time - window_wall_time );
+					window_wall_time = wall_time;
+					window_sim_time = sim_time;
+				}
+			}
+		}
+		catch ( const std::exception& e )
+		{
+			error_message_ = e.what();
+		}
+		finished_ = true;
+	}
+}
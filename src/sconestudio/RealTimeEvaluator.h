@@ -0,0 +1,61 @@
+/*
+** RealTimeEvaluator.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "scone/core/types.h"
+#include "StudioModel.h"
+
+namespace scone
+{
+	/// Advances a StudioModel in a separate thread, paced to wall-clock time times the slow motion factor.
+	/// The model is advanced in small chunks, other threads must lock() before accessing the model.
+	/// When the simulation falls behind more than max_step, the step is clamped and pacing restarts from there.
+	class RealTimeEvaluator
+	{
+	public:
+		RealTimeEvaluator( StudioModel& model, double slow_motion_factor, TimeInSeconds max_step );
+		~RealTimeEvaluator();
+
+		std::unique_lock<std::mutex> lock() { return std::unique_lock( model_mutex_ ); }
+
+		/// stop the evaluation and wait for the thread to finish
+		void stop();
+
+		/// true if the simulation has ended or has produced an error
+		bool isFinished() const { return finished_; }
+		/// error message of the simulation, only valid after isFinished() or stop()
+		const String& errorMessage() const { return error_message_; }
+
+		void setSlowMotionFactor( double f ) { slow_motion_factor_ = f; }
+
+		TimeInSeconds simTime() const { return sim_time_; }
+		TimeInSeconds lag() const { return lag_; } // simulation time behind the paced time
+		double realTimeFactor() const { return real_time_factor_; } // simulation time per wall-clock second
+		int clampedSteps() const { return clamped_steps_; }
+
+	private:
+		void threadFunc();
+
+		StudioModel& model_;
+		TimeInSeconds max_step_;
+		std::atomic<double> slow_motion_factor_;
+		std::atomic<TimeInSeconds> sim_time_;
+		std::atomic<TimeInSeconds> lag_;
+		std::atomic<double> real_time_factor_;
+		std::atomic<int> clamped_steps_;
+		std::atomic<bool> stop_;
+		std::atomic<bool> finished_;
+		String error_message_;
+		std::mutex model_mutex_;
+		std::thread thread_;
+	};
+}
@@ -0,0 +1,220 @@
+/*
+** ResultsCatalog.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "ResultsCatalog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QDoubleValidator>
+#include <QDir>
+#include <QDirIterator>
+#include <algorithm>
+#include <map>
+#include "scone/core/Log.h"
+#include "xo/time/timer.h"
+
+namespace scone
+{
+	enum CatalogColumn { ScenarioCol, SeedCol, GenCol, ScoreCol, ModifiedCol, FolderCol, ColumnCount };
+
+	// interval at which the results are refreshed while folders are being indexed
+	constexpr int catalog_refresh_interval = 1000;
+
+	ResultsCatalog::ResultsCatalog( QWidget* parent ) :
+		QWidget( parent ),
+		indexer( new ResultsIndexer( this ) ),
+		pendingCount( 0 )
+	{
+		auto* layout = new QVBoxLayout( this );
+		layout->setContentsMargins( 0, 0, 0, 0 );
+		layout->setSpacing( 2 );
+
+		querySelect = new QComboBox( this );
+		querySelect->addItem( "Best run per scenario", BestPerScenario );
+		querySelect->addItem( "Recent runs", RecentRuns );
+		querySelect->addItem( "Runs grouped by seed", RunsBySeed );
+		connect( querySelect, QOverload<int>::of( &QComboBox::currentIndexChanged ), this, [this]() { updateControls(); refresh(); } );
+
+		scenarioFilter = new QLineEdit( this );
+		scenarioFilter->setPlaceholderText( "Scenario" );
+		scenarioFilter->setClearButtonEnabled( true );
+		connect( scenarioFilter, &QLineEdit::returnPressed, this, &ResultsCatalog::refresh );
+
+		maxScore = new QLineEdit( this );
+		maxScore->setPlaceholderText( "Score better than" );
+		maxScore->setToolTip( "Only show results with a better score; lower is better for minimizing objectives, higher for maximizing objectives and sconegym results" );
+		maxScore->setValidator( new QDoubleValidator( maxScore ) );
+		maxScore->setMaximumWidth( 80 );
+		connect( maxScore, &QLineEdit::returnPressed, this, &ResultsCatalog::refresh );
+
+		maxAgeHours = new QSpinBox( this );
+		maxAgeHours->setRange( 1, 24 * 365 );
+		maxAgeHours->setValue( 24 );
+		maxAgeHours->setSuffix( " h" );
+		connect( maxAgeHours, QOverload<int>::of( &QSpinBox::valueChanged ), this, &ResultsCatalog::refresh );
+
+		auto* refreshButton = new QPushButton( this );
+		refreshButton->setIcon( style()->standardIcon( QStyle::SP_BrowserReload ) );
+		refreshButton->setSizePolicy( QSizePolicy::Fixed, QSizePolicy::Minimum );
+		connect( refreshButton, &QPushButton::clicked, this, &ResultsCatalog::refresh );
+
+		auto* queryLayout = new QHBoxLayout();
+		queryLayout->addWidget( querySelect );
+		queryLayout->addWidget( scenarioFilter );
+		queryLayout->addWidget( maxScore );
+		queryLayout->addWidget( maxAgeHours );
+		queryLayout->addWidget( refreshButton );
+		layout->addLayout( queryLayout );
+
+		resultsTree = new QTreeWidget( this );
+		resultsTree->setColumnCount( ColumnCount );
+		resultsTree->setHeaderLabels( { "Scenario", "Seed", "Gen", "Score", "Modified", "Folder" } );
+		resultsTree->setRootIsDecorated( false );
+		resultsTree->setUniformRowHeights( true );
+		resultsTree->header()->setSectionResizeMode( QHeaderView::ResizeToContents );
+		connect( resultsTree, &QTreeWidget::itemActivated, this, [this]( QTreeWidgetItem* item, int ) {
+			if ( auto dir = item->data( FolderCol, Qt::UserRole ).toString(); !dir.isEmpty() )
+				emit resultActivated( dir ); } );
+		layout->addWidget( resultsTree );
+
+		statusLabel = new QLabel( this );
+		layout->addWidget( statusLabel );
+
+		// refresh periodically while indexing, instead of after every folder
+		refreshTimer.setSingleShot( true );
+		connect( &refreshTimer, &QTimer::timeout, this, [this]() { if ( isVisible() ) refresh(); } );
+		connect( indexer, &ResultsIndexer::statusReady, this, [this]() {
+			pendingCount = std::max( 0, pendingCount - 1 );
+			if ( pendingCount == 0 )
+				refreshTimer.start( 0 );
+			else if ( !refreshTimer.isActive() )
+				refreshTimer.start( catalog_refresh_interval ); }, Qt::QueuedConnection );
+
+		updateControls();
+	}
+
+	void ResultsCatalog::indexResultsFolder( const QString& resultsFolder )
+	{
+		xo::timer t;
+		QStringList dirs;
+		for ( QDirIterator it( resultsFolder, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories ); it.hasNext(); )
+		{
+			auto dir = it.next();
+			if ( auto stat = GetResultsIndex().find( dir ); !stat || !isResultStatusUpToDate( *stat, it.fileInfo() ) )
+				dirs.push_back( dir );
+		}
+		indexer->clearRequests();
+		indexer->appendRequests( dirs );
+		pendingCount = dirs.size();
+		log::debug( "Requested indexing of ", pendingCount, " result folders in ", t().secondsd(), " seconds" );
+	}
+
+	void ResultsCatalog::refresh()
+	{
+		xo::timer t;
+		const auto query = Query( querySelect->currentData().toInt() );
+		const auto scenario = scenarioFilter->text().trimmed();
+		bool has_max_score = false;
+		const auto max_score = maxScore->text().toDouble( &has_max_score );
+		const auto min_modified = QDateTime::currentDateTime().addSecs( -3600 * qint64( maxAgeHours->value() ) );
+
+		// select matching entries
+		auto entries = GetResultsIndex().entries();
+		auto new_end = std::remove_if( entries.begin(), entries.end(), [&]( const Entry& e ) {
+			const auto& s = e.second;
+			if ( s.type == ResultStatus::Type::Invalid )
+				return true;
+			if ( !scenario.isEmpty() && !s.scenario.contains( scenario, Qt::CaseInsensitive ) )
+				return true;
+			if ( has_max_score && !s.isBetterScore( s.best, max_score ) )
+				return true;
+			if ( query == RecentRuns && s.modified < min_modified )
+				return true;
+			return false; } );
+		entries.erase( new_end, entries.end() );
+		auto num_matches = entries.size();
+
+		resultsTree->setUpdatesEnabled( false );
+		resultsTree->clear();
+		QList<QTreeWidgetItem*> items;
+		switch ( query )
+		{
+		case BestPerScenario:
+		{
+			std::map<QString, const Entry*> best;
+			for ( const auto& e : entries )
+				if ( auto& b = best[ e.second.scenario ]; !b || e.second.isBetterScore( e.second.best, b->second.best ) )
+					b = &e;
+			for ( const auto& [name, e] : best )
+				items.push_back( makeItem( *e ) );
+			break;
+		}
+		case RecentRuns:
+		{
+			std::sort( entries.begin(), entries.end(), []( const Entry& a, const Entry& b ) { return a.second.modified > b.second.modified; } );
+			for ( const auto& e : entries )
+				items.push_back( makeItem( e ) );
+			break;
+		}
+		case RunsBySeed:
+		{
+			std::map<int, std::vector<const Entry*>> seeds;
+			for ( const auto& e : entries )
+				seeds[ e.second.seed ].push_back( &e );
+			for ( auto& [seed, runs] : seeds )
+			{
+				std::sort( runs.begin(), runs.end(), []( auto* a, auto* b ) {
+					// runs of a seed can mix objectives, so sort by a consistent key
+					auto rank = []( const ResultStatus& s ) { return s.is_minimizing ? s.best : -s.best; };
+					return rank( a->second ) < rank( b->second ); } );
+				auto* group = new QTreeWidgetItem();
+				group->setText( ScenarioCol, seed >= 0 ? QString( "Seed %1" ).arg( seed ) : QString( "Unknown seed" ) );
+				group->setText( FolderCol, QString( "%1 runs" ).arg( runs.size() ) );
+				for ( auto* e : runs )
+					group->addChild( makeItem( *e ) );
+				items.push_back( group );
+			}
+			break;
+		}
+		}
+		resultsTree->setRootIsDecorated( query == RunsBySeed );
+		resultsTree->addTopLevelItems( items );
+		if ( query == RunsBySeed )
+			resultsTree->expandAll();
+		resultsTree->setUpdatesEnabled( true );
+
+		auto status = QString( "%1 of %2 results (%3 ms)" ).arg( num_matches ).arg( GetResultsIndex().size() ).arg( t().secondsd() * 1000, 0, 'f', 1 );
+		if ( pendingCount > 0 )
+			status += QString( "; %1 folders not indexed yet" ).arg( pendingCount );
+		statusLabel->setText( status );
+	}
+
+	QTreeWidgetItem* ResultsCatalog::makeItem( const Entry& e ) const
+	{
+		const auto& s = e.second;
+		auto* item = new QTreeWidgetItem();
+		item->setText( ScenarioCol, s.scenario );
+		item->setText( SeedCol, s.seed >= 0 ? QString::number( s.seed ) : QString() );
+		item->setText( GenCol, QString::number( s.gen ) );
+		item->setText( ScoreCol, QString::asprintf( "%7.3f", s.best ) );
+		item->setText( ModifiedCol, s.modified.toString( "yyyy-MM-dd hh:mm" ) );
+		item->setText( FolderCol, QDir( e.first ).dirName() );
+		item->setData( FolderCol, Qt::UserRole, e.first );
+		item->setToolTip( FolderCol, e.first );
+		item->setTextAlignment( GenCol, Qt::AlignRight );
+		item->setTextAlignment( ScoreCol, Qt::AlignRight );
+		return item;
+	}
+
+	void ResultsCatalog::updateControls()
+	{
+		maxAgeHours->setVisible( querySelect->currentData().toInt() == RecentRuns );
+	}
+}
@@ -0,0 +1,58 @@
+/*
+** ResultsCatalog.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QLabel>
+#include <QTimer>
+#include "ResultsIndex.h"
+
+namespace scone
+{
+	/// Queries over the results index, across all result folders that have been indexed.
+	/// Folders in the results folder that are not indexed yet are indexed in the background.
+	class ResultsCatalog : public QWidget
+	{
+		Q_OBJECT
+
+	public:
+		enum Query { BestPerScenario, RecentRuns, RunsBySeed };
+
+		ResultsCatalog( QWidget* parent );
+		virtual ~ResultsCatalog() = default;
+
+	signals:
+		void resultActivated( const QString& dir );
+
+	public slots:
+		void refresh();
+		/// request indexing of all folders inside resultsFolder that are missing or outdated
+		void indexResultsFolder( const QString& resultsFolder );
+
+	private:
+		using Entry = std::pair<QString, ResultStatus>;
+		QTreeWidgetItem* makeItem( const Entry& e ) const;
+		void updateControls();
+
+		QComboBox* querySelect;
+		QLineEdit* scenarioFilter;
+		QLineEdit* maxScore;
+		QSpinBox* maxAgeHours;
+		QTreeWidget* resultsTree;
+		QLabel* statusLabel;
+
+		ResultsIndexer* indexer;
+		int pendingCount;
+		QTimer refreshTimer;
+	};
+}
@@ -20,104 +20,80 @@
 #include "qt_convert.h"
 #include "xo/filesystem/filesystem.h"
 #include "xo/time/timer.h"
+#include "ResultsIndex.h"
 
-#define SCONE_USE_RESULTS_CACHE 0
-
-xo::path results_cache_file() { return scone::GetSettingsFolder() / "results_cache.zml"; }
-
-namespace xo {
-	bool from_prop_node( const prop_node& pn, ResultsFileSystemModel::Status& stat ) {
-		stat.gen = pn.get<int>( "gen" );
-		stat.best = pn.get<double>( "best" );
-		stat.modified.fromString( to_qt( pn.get<string>( "best" ) ), Qt::ISODate );
-		return true;
-	}
-	prop_node to_prop_node( const ResultsFileSystemModel::Status& stat ) {
-		prop_node pn;
-		pn["gen"] = stat.gen;
-		pn["best"] = stat.best;
-		pn["modified"] = stat.modified.toString( Qt::ISODate ).toStdString();
-		return pn;
-	}
-}
-
-ResultsFileSystemModel::ResultsFileSystemModel( QObject* parent ) : QFileSystemModel( parent )
+ResultsFileSystemModel::ResultsFileSystemModel( QObject* parent ) :
+	QFileSystemModel( parent ),
+	m_Indexer( new scone::ResultsIndexer( this ) )
 {
-#if SCONE_USE_RESULTS_CACHE
-	auto f = results_cache_file();
-	if ( xo::file_exists( f ) )
-	{
-		xo::error_code ec;
-		auto status_cache = xo::load_file( f, &ec );
-		if ( ec.good() )
-			xo::from_prop_node( status_cache, m_StatusCache );
-	}
-#endif
+	connect( m_Indexer, &scone::ResultsIndexer::statusReady, this, &ResultsFileSystemModel::updateStatus, Qt::QueuedConnection );
+
+	// keep the index up-to-date with file system changes reported by QFileSystemModel
+	connect( this, &QFileSystemModel::directoryLoaded, this, &ResultsFileSystemModel::indexDirectory );
+	connect( this, &QAbstractItemModel::rowsAboutToBeRemoved, this, &ResultsFileSystemModel::removeFromIndex );
+	connect( this, &QFileSystemModel::fileRenamed, this, [this]( const QString& path, const QString& oldName, const QString& newName ) {
+		scone::GetResultsIndex().remove( path + "/" + oldName );
+		m_Indexer->request( path + "/" + newName, false );
+		} );
 }
 
 ResultsFileSystemModel::~ResultsFileSystemModel()
 {
-#if SCONE_USE_RESULTS_CACHE
-	xo::error_code ec;
-	auto status_cache = xo::to_prop_node( m_StatusCache );
-	xo::save_file( status_cache, results_cache_file(), &ec );
-#endif
+	// stop the indexer thread before the model is destroyed, then save the index while logging is still available
+	delete m_Indexer;
+	scone::GetResultsIndex().saveIfModified();
 }
 
-ResultsFileSystemModel::Status ResultsFileSystemModel::getStatus( QFileInfo& fi ) const
+ResultsFileSystemModel::Status ResultsFileSystemModel::getStatus( QFileInfo& fi, bool* pending ) const
 {
-	Status stat;
-	if ( fi.isFile() && ( fi.suffix() == "par" || fi.suffix() == "sto" || fi.suffix() == "stob" ) )
+	if ( fi.isDir() )
 	{
-		auto split = fi.completeBaseName().split( "_" );
-		if ( split.size() == 3 )
-			stat.type = Status::Type::Par;
-		if ( split.size() == 2 )
-			stat.type = Status::Type::Pt;
-
-		if ( stat.type != Status::Type::Invalid )
+		fi.refresh();
+		QString dirname = fi.absoluteFilePath();
+		auto stat = scone::GetResultsIndex().find( dirname );
+		if ( !stat || !scone::isResultStatusUpToDate( *stat, fi ) )
 		{
-			bool ok = false;
-			if ( auto gen = split[0].toInt( &ok ); ok )
-				stat.gen = gen;
-			else stat.type = Status::Type::Invalid;
-			if ( auto best = split.back().toDouble( &ok ); ok )
-				stat.best = best;
-			else stat.type = Status::Type::Invalid;
+			// data() is only called for visible rows, the most recent request is handled first
+			m_Indexer->request( dirname );
+			if ( pending )
+				*pending = true;
 		}
+		return stat ? *stat : Status();
 	}
-	else if ( fi.isDir() )
-	{
-		fi.refresh();
-		QString dirname = fi.absoluteFilePath();
-		auto cache_it = m_StatusCache.find( dirname );
-		if ( cache_it != m_StatusCache.end() && abs( cache_it->modified.secsTo( fi.lastModified() ) ) < 3 )
-			return *cache_it;
+	else return scone::getResultFileStatus( fi );
+}
 
-		// Using log here causes a recursive loop for some reason
-		//std::cout << "Scanning folder " << fi.absoluteFilePath().toStdString() << std::endl;
-		for ( QDirIterator dir_it( dirname, { "*.par", "*.sto", "*.stob" }, QDir::Files ); dir_it.hasNext(); )
-		{
-			QFileInfo fileinf = QFileInfo( dir_it.next() );
-			if ( fileinf.isFile() ) {
-				auto fs = getStatus( fileinf );
-				if ( stat.type == Status::Type::Invalid )
-					stat = fs;
-				if ( fs.type == Status::Type::Par && fs.gen >= stat.gen )
-					stat = fs;
-				if ( fs.type == Status::Type::Pt ) {
-					xo::set_if_bigger( stat.gen, fs.gen );
-					xo::set_if_bigger( stat.best, fs.best );
-				}
-			}
-			else if ( fileinf.fileName() != ".." && fileinf.fileName() != "." ) {
-				// do something?
-			}
+void ResultsFileSystemModel::indexDirectory( const QString& path )
+{
+	// index sub folders in the background, after the requests for visible rows
+	auto parent = index( path );
+	for ( int row = 0; row < rowCount( parent ); ++row )
+	{
+		auto fi = fileInfo( index( row, 0, parent ) );
+		if ( fi.isDir() ) {
+			auto stat = scone::GetResultsIndex().find( fi.absoluteFilePath() );
+			if ( !stat || !scone::isResultStatusUpToDate( *stat, fi ) )
+				m_Indexer->request( fi.absoluteFilePath(), false );
 		}
-		stat.modified = fi.lastModified();
-		m_StatusCache[dirname] = stat;
 	}
-	return stat;
+}
+
+void ResultsFileSystemModel::removeFromIndex( const QModelIndex& parent, int first, int last )
+{
+	for ( int row = first; row <= last; ++row )
+	{
+		auto fi = fileInfo( index( row, 0, parent ) );
+		if ( fi.isDir() )
+			scone::GetResultsIndex().remove( fi.absoluteFilePath() );
+	}
+}
+
+void ResultsFileSystemModel::updateStatus( const QString& dir, const scone::ResultStatus& stat )
+{
+	auto first = index( dir, QFileSystemModel::columnCount() + GenCol );
+	auto last = index( dir, QFileSystemModel::columnCount() + ScoreCol );
+	if ( first.isValid() )
+		emit dataChanged( first, last, { Qt::DisplayRole } );
 }
 
 QVariant ResultsFileSystemModel::headerData( int section, Qt::Orientation orientation, int role ) const
@@ -152,7 +128,10 @@ QVariant ResultsFileSystemModel::data( const QModelIndex& idx, int role ) const
 	if ( idx.column() >= QFileSystemModel::columnCount() ) {
 		if ( role == Qt::DisplayRole ) {
 			auto fi = fileInfo( idx );
-			auto stat = getStatus( fi );
+			bool pending = false;
+			auto stat = getStatus( fi, &pending );
+			if ( pending && stat.type == Status::Type::Invalid )
+				return QVariant( QString( "..." ) );
 			if ( stat.type == Status::Type::Invalid )
 				return QVariant( QString( "" ) );
 
@@ -11,6 +11,7 @@
 #include <QFileSystemModel>
 #include <QDateTime>
 #include "xo/container/flat_map.h"
+#include "ResultsIndexer.h"
 
 class ResultsFileSystemModel : public QFileSystemModel
 {
@@ -23,19 +24,18 @@ public:
 	enum Column { GenCol = 0, ScoreCol = 1, ColCount = 2 };
 	virtual int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
 
-	struct Status {
-		enum class Type { Invalid, Par, Pt };
-		int gen = 0;
-		double best = 0.0;
-		Type type = Type::Invalid;
-		QDateTime modified;
-	};
+	using Status = scone::ResultStatus;
+
+private slots:
+	void updateStatus( const QString& dir, const scone::ResultStatus& stat );
+	void indexDirectory( const QString& path );
+	void removeFromIndex( const QModelIndex& parent, int first, int last );
 
 private:
-	Status getStatus( QFileInfo& fi ) const;
+	Status getStatus( QFileInfo& fi, bool* pending = nullptr ) const;
 	virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const override;
 	virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
 	virtual Qt::ItemFlags flags( const QModelIndex& index ) const override;
 
-	mutable QHash<QString, Status> m_StatusCache;
+	scone::ResultsIndexer* m_Indexer;
 };
@@ -0,0 +1,162 @@
+/*
+** ResultsIndex.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "ResultsIndex.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include "scone/core/Log.h"
+#include "scone/core/system_tools.h"
+#include "xo/time/timer.h"
+#include "qt_convert.h"
+
+namespace scone
+{
+	constexpr quint32 results_index_magic = 0x53524958; // "SRIX"
+	constexpr quint32 results_index_version = 4;
+
+	ResultsIndex::ResultsIndex( const xo::path& file ) :
+		file_( file ),
+		modified_( false )
+	{
+		load();
+	}
+
+	std::optional<ResultStatus> ResultsIndex::find( const QString& dir ) const
+	{
+		std::scoped_lock lock( mutex_ );
+		if ( auto it = entries_.find( dir ); it != entries_.end() )
+			return *it;
+		else return std::nullopt;
+	}
+
+	void ResultsIndex::insert( const QString& dir, const ResultStatus& stat )
+	{
+		std::scoped_lock lock( mutex_ );
+		entries_[ dir ] = stat;
+		modified_ = true;
+	}
+
+	void ResultsIndex::remove( const QString& dir )
+	{
+		std::scoped_lock lock( mutex_ );
+		modified_ |= entries_.remove( dir ) > 0;
+	}
+
+	std::vector<std::pair<QString, ResultStatus>> ResultsIndex::entries() const
+	{
+		std::scoped_lock lock( mutex_ );
+		std::vector<std::pair<QString, ResultStatus>> result;
+		result.reserve( entries_.size() );
+		for ( auto it = entries_.begin(); it != entries_.end(); ++it )
+			result.emplace_back( it.key(), it.value() );
+		return result;
+	}
+
+	size_t ResultsIndex::size() const
+	{
+		std::scoped_lock lock( mutex_ );
+		return entries_.size();
+	}
+
+	bool ResultsIndex::load()
+	{
+		QFile file( to_qt( file_ ) );
+		if ( !file.open( QIODevice::ReadOnly ) )
+			return false;
+
+		xo::timer t;
+		QDataStream str( &file );
+		str.setVersion( QDataStream::Qt_5_9 );
+		quint32 magic = 0, version = 0, count = 0;
+		str >> magic >> version >> count;
+		if ( magic != results_index_magic || version != results_index_version ) {
+			log::debug( "Ignoring results index ", file_, " with unsupported version" );
+			return false;
+		}
+
+		QHash<QString, ResultStatus> entries;
+		entries.reserve( count );
+		for ( quint32 i = 0; i < count && str.status() == QDataStream::Ok; ++i )
+		{
+			QString dir;
+			ResultStatus stat;
+			qint32 gen, seed, file_count;
+			qint8 type;
+			qint64 modified;
+			str >> dir >> gen >> stat.best >> type >> modified >> stat.scenario >> stat.scenario_hash >> seed >> stat.best_file >> file_count >> stat.is_minimizing;
+			stat.gen = gen;
+			stat.seed = seed;
+			stat.file_count = file_count;
+			stat.type = ResultStatus::Type( type );
+			stat.modified = QDateTime::fromMSecsSinceEpoch( modified );
+			entries.insert( dir, stat );
+		}
+		if ( str.status() != QDataStream::Ok ) {
+			log::warning( "Could not read results index ", file_ );
+			return false;
+		}
+
+		// remove folders that were deleted or moved since the index was saved
+		auto pruned = entries.size();
+		for ( auto it = entries.begin(); it != entries.end(); )
+			it = QFileInfo( it.key() ).isDir() ? std::next( it ) : entries.erase( it );
+		pruned -= entries.size();
+
+		std::scoped_lock lock( mutex_ );
+		entries_.swap( entries );
+		modified_ = pruned > 0;
+		log::debug( "Loaded ", entries_.size(), " entries from ", file_, " in ", t().secondsd(), " seconds; removed ", pruned, " missing folders" );
+		return true;
+	}
+
+	bool ResultsIndex::save()
+	{
+		std::scoped_lock lock( mutex_ );
+
+		// QSaveFile writes to a temporary file first, so an existing index is never left half-written
+		QSaveFile file( to_qt( file_ ) );
+		if ( !file.open( QIODevice::WriteOnly ) )
+			return false;
+
+		QDataStream str( &file );
+		str.setVersion( QDataStream::Qt_5_9 );
+		str << results_index_magic << results_index_version << quint32( entries_.size() );
+		for ( auto it = entries_.begin(); it != entries_.end(); ++it )
+		{
+			const auto& stat = it.value();
+			str << it.key() << qint32( stat.gen ) << stat.best << qint8( stat.type )
+				<< qint64( stat.modified.toMSecsSinceEpoch() ) << stat.scenario << stat.scenario_hash << qint32( stat.seed )
+				<< stat.best_file << qint32( stat.file_count ) << stat.is_minimizing;
+		}
+
+		if ( !file.commit() ) {
+			log::warning( "Could not write results index ", file_ );
+			return false;
+		}
+		modified_ = false;
+		return true;
+	}
+
+	bool ResultsIndex::saveIfModified()
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			if ( !modified_ )
+				return false;
+		}
+		return save();
+	}
+
+	ResultsIndex& GetResultsIndex()
+	{
+		static ResultsIndex index( GetSettingsFolder() / "results_index.bin" );
+		return index;
+	}
+}
@@ -0,0 +1,48 @@
+/*
+** ResultsIndex.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "xo/filesystem/path.h"
+#include "ResultsIndexer.h"
+
+namespace scone
+{
+	/// Persistent index of result folder status, stored as a compact binary file in the settings folder.
+	/// Entries are valid as long as the modification time of their folder is unchanged.
+	/// All members are thread-safe. The index is not saved on destruction, because the shared index is a
+	/// function static that outlives the log sinks; owners call saveIfModified() explicitly at shutdown.
+	class ResultsIndex
+	{
+	public:
+		ResultsIndex( const xo::path& file );
+
+		std::optional<ResultStatus> find( const QString& dir ) const;
+		void insert( const QString& dir, const ResultStatus& stat );
+		void remove( const QString& dir );
+		std::vector<std::pair<QString, ResultStatus>> entries() const;
+		size_t size() const;
+
+		bool load();
+		bool save();
+		bool saveIfModified();
+
+	private:
+		mutable std::mutex mutex_;
+		QHash<QString, ResultStatus> entries_;
+		xo::path file_;
+		bool modified_;
+	};
+
+	ResultsIndex& GetResultsIndex();
+}
@@ -0,0 +1,212 @@
+/*
+** ResultsIndexer.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "ResultsIndexer.h"
+
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QRegularExpression>
+#include <algorithm>
+#include <chrono>
+#include "xo/numerical/math.h"
+#include "ResultsIndex.h"
+
+namespace scone
+{
+	// minimum time between two saves of the index while folders are being indexed
+	constexpr auto index_save_interval = std::chrono::seconds( 30 );
+
+	ResultStatus getResultFileStatus( const QFileInfo& fi )
+	{
+		ResultStatus stat;
+		if ( fi.isFile() && ( fi.suffix() == "par" || fi.suffix() == "sto" || fi.suffix() == "stob" ) )
+		{
+			auto split = fi.completeBaseName().split( "_" );
+			if ( split.size() == 3 )
+				stat.type = ResultStatus::Type::Par;
+			if ( split.size() == 2 ) {
+				stat.type = ResultStatus::Type::Pt;
+				stat.is_minimizing = false; // sconegym rewards
+			}
+
+			if ( stat.type != ResultStatus::Type::Invalid )
+			{
+				bool ok = false;
+				if ( auto gen = split[0].toInt( &ok ); ok )
+					stat.gen = gen;
+				else stat.type = ResultStatus::Type::Invalid;
+				if ( auto best = split.back().toDouble( &ok ); ok )
+					stat.best = best;
+				else stat.type = ResultStatus::Type::Invalid;
+			}
+		}
+		return stat;
+	}
+
+	ResultStatus scanResultFolder( const QString& dir, QFileInfoList* par_files )
+	{
+		ResultStatus stat;
+		QString best_file;
+		int best_file_gen = -1, file_count = 0;
+		ResultStatus first_par; // .par file with the lowest generation
+		first_par.gen = -1;
+		for ( QDirIterator dir_it( dir, { "*.par", "*.sto", "*.stob" }, QDir::Files ); dir_it.hasNext(); )
+		{
+			QFileInfo fileinf = QFileInfo( dir_it.next() );
+			if ( fileinf.isFile() ) {
+				auto fs = getResultFileStatus( fileinf );
+				if ( fs.type != ResultStatus::Type::Invalid )
+					++file_count;
+				if ( par_files && fs.type == ResultStatus::Type::Par && fileinf.suffix() == "par" )
+					par_files->push_back( fileinf );
+				if ( fs.type == ResultStatus::Type::Par && fileinf.suffix() == "par" && fs.gen > best_file_gen ) {
+					best_file = fileinf.fileName();
+					best_file_gen = fs.gen;
+				}
+				if ( stat.type == ResultStatus::Type::Invalid )
+					stat = fs;
+				if ( fs.type == ResultStatus::Type::Par && fs.gen >= stat.gen )
+					stat = fs;
+				if ( fs.type == ResultStatus::Type::Par && ( first_par.gen < 0 || fs.gen < first_par.gen ) )
+					first_par = fs;
+				if ( fs.type == ResultStatus::Type::Pt ) {
+					xo::set_if_bigger( stat.gen, fs.gen );
+					xo::set_if_bigger( stat.best, fs.best );
+				}
+			}
+		}
+		stat.modified = QFileInfo( dir ).lastModified();
+		stat.best_file = best_file;
+		stat.file_count = file_count;
+
+		// result folders are named date.time.scenario.signature
+		stat.scenario = QFileInfo( dir ).fileName().section( '.', 2, 2 );
+		QFile config( dir + "/config.scone" );
+		if ( config.open( QIODevice::ReadOnly ) ) {
+			auto data = config.readAll();
+			auto hash = QCryptographicHash::hash( data, QCryptographicHash::Md5 );
+			for ( int i = 0; i < 8; ++i )
+				stat.scenario_hash = ( stat.scenario_hash << 8 ) | quint8( hash[ i ] );
+			static const QRegularExpression seed_exp( "random_seed\\s*=\\s*(\\d+)" );
+			if ( auto match = seed_exp.match( QString::fromUtf8( data ) ); match.hasMatch() )
+				stat.seed = match.captured( 1 ).toInt();
+			static const QRegularExpression maximize_exp( "\\bminimize\\s*=\\s*(0|false)\\b" );
+			if ( stat.type == ResultStatus::Type::Par && maximize_exp.match( QString::fromUtf8( data ) ).hasMatch() )
+				stat.is_minimizing = false;
+		}
+
+		// .par files are only written when the score improves, so their order shows the direction
+		if ( stat.type == ResultStatus::Type::Par && first_par.gen >= 0 && first_par.gen < stat.gen && first_par.best != stat.best )
+			stat.is_minimizing = stat.best < first_par.best;
+
+		return stat;
+	}
+
+	bool isResultStatusUpToDate( const ResultStatus& stat, const QFileInfo& dir )
+	{
+		return abs( stat.modified.secsTo( dir.lastModified() ) ) < 3;
+	}
+
+	ResultsIndexer::ResultsIndexer( QObject* parent ) :
+		QObject( parent ),
+		stop_( false )
+	{
+		qRegisterMetaType<scone::ResultStatus>();
+		thread_ = std::thread( &ResultsIndexer::threadFunc, this );
+	}
+
+	ResultsIndexer::~ResultsIndexer()
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			stop_ = true;
+		}
+		condition_.notify_one();
+		if ( thread_.joinable() )
+			thread_.join();
+	}
+
+	void ResultsIndexer::request( const QString& dir, bool visible )
+	{
+		{
+			// visible rows are moved to the front, so that they are handled first
+			std::scoped_lock lock( mutex_ );
+			auto it = std::find( requests_.begin(), requests_.end(), dir );
+			if ( it != requests_.end() && !visible )
+				return;
+			if ( it != requests_.end() )
+				requests_.erase( it );
+			if ( visible )
+				requests_.push_front( dir );
+			else requests_.push_back( dir );
+		}
+		condition_.notify_one();
+	}
+
+	void ResultsIndexer::appendRequests( const QStringList& dirs )
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			requests_.insert( requests_.end(), dirs.begin(), dirs.end() );
+		}
+		condition_.notify_one();
+	}
+
+	void ResultsIndexer::clearRequests()
+	{
+		std::scoped_lock lock( mutex_ );
+		requests_.clear();
+	}
+
+	void ResultsIndexer::threadFunc()
+	{
+		// the index is written when all requests are handled, at most once per save interval and on exit
+		auto last_save = std::chrono::steady_clock::now() - index_save_interval;
+		bool save_pending = false;
+		auto save = [&]() {
+			GetResultsIndex().saveIfModified();
+			last_save = std::chrono::steady_clock::now();
+			save_pending = false;
+		};
+
+		while ( true )
+		{
+			QString dir;
+			{
+				std::unique_lock lock( mutex_ );
+				while ( !stop_ && requests_.empty() )
+				{
+					if ( save_pending && std::chrono::steady_clock::now() >= last_save + index_save_interval )
+					{
+						lock.unlock();
+						save();
+						lock.lock();
+					}
+					else if ( save_pending )
+						condition_.wait_until( lock, last_save + index_save_interval );
+					else condition_.wait( lock );
+				}
+				if ( stop_ )
+					break;
+				dir = requests_.front();
+				requests_.pop_front();
+			}
+
+			auto stat = scanResultFolder( dir );
+			GetResultsIndex().insert( dir, stat );
+			save_pending = true;
+
+			// signal is delivered to the GUI thread through a queued connection
+			emit statusReady( dir, stat );
+		}
+
+		if ( save_pending )
+			save();
+	}
+}
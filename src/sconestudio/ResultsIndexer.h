@@ -0,0 +1,75 @@
+/*
+** ResultsIndexer.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QFileInfo>
+#include <QDateTime>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace scone
+{
+	/// Gen / score status of a result file or folder
+	struct ResultStatus {
+		enum class Type { Invalid, Par, Pt };
+		int gen = 0;
+		double best = 0.0;
+		Type type = Type::Invalid;
+		QDateTime modified;
+		QString scenario;
+		quint64 scenario_hash = 0;
+		int seed = -1;
+		QString best_file; // .par file with the highest generation, empty if none
+		int file_count = 0; // number of result files in the folder
+		bool is_minimizing = true; // false if higher scores are better
+
+		bool isBetterScore( double a, double b ) const { return is_minimizing ? a < b : a > b; }
+	};
+
+	ResultStatus getResultFileStatus( const QFileInfo& fi );
+	/// Scan all result files in a folder, optionally returning the valid .par files
+	ResultStatus scanResultFolder( const QString& dir, QFileInfoList* par_files = nullptr );
+	bool isResultStatusUpToDate( const ResultStatus& stat, const QFileInfo& dir );
+
+	/// Computes the status of result folders in a background thread and stores it in the ResultsIndex.
+	/// Most recent requests for visible rows are handled first, other requests are handled last.
+	/// The index is saved when the thread is idle, at most every 30 seconds, and when the indexer is destroyed.
+	class ResultsIndexer : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		ResultsIndexer( QObject* parent = nullptr );
+		virtual ~ResultsIndexer();
+
+		void request( const QString& dir, bool visible = true );
+		/// add requests that are handled last, without checking if they are already queued
+		void appendRequests( const QStringList& dirs );
+		void clearRequests();
+
+	signals:
+		void statusReady( const QString& dir, const scone::ResultStatus& status );
+
+	private:
+		void threadFunc();
+
+		std::thread thread_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::deque<QString> requests_;
+		bool stop_;
+	};
+}
+
+Q_DECLARE_METATYPE( scone::ResultStatus )
@@ -9,7 +9,7 @@
 #include "SconeStorageDataModel.h"
 #include "xo/numerical/math.h"
 #include "scone/core/Log.h"
-#include "gui_profiler.h"
+#include "studio_profiler.h"
 
 SconeStorageDataModel::SconeStorageDataModel( const scone::Storage<>* s ) :
 	storage( s ),
@@ -19,7 +19,7 @@ SconeStorageDataModel::SconeStorageDataModel( const scone::Storage<>* s ) :
 
 void SconeStorageDataModel::setStorage( const scone::Storage<>* s )
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	index_cache = { -1, 0 };
 	storage = s;
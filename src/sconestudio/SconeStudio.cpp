@@ -42,15 +42,19 @@
 #include "scone/sconelib_config.h"
 
 #include <QFileDialog>
+#include <QGuiApplication>
+#include <QLabel>
+#include <QScreen>
 #include <QMessageBox>
 #include <QTabWidget>
 #include <QTextStream>
+#include <map>
 #include <osgDB/ReadFile>
 
 #include "qcustomplot/qcustomplot.h"
 #include "qt_convert.h"
 #include "qtfx.h"
-#include "gui_profiler.h"
+#include "studio_profiler.h"
 
 #include "vis-osg/osg_object_manager.h"
 #include "vis-osg/osg_tools.h"
@@ -75,8 +79,7 @@ SconeStudio::SconeStudio( QWidget* parent, Qt::WindowFlags flags ) :
 	scene_( true, GetStudioSetting< float >( "viewer.ambient_intensity" ) ),
 	slomo_factor( 1 ),
 	com_delta( Vec3( 0, 0, 0 ) ),
-	drag_distance_( 0 ),
-	captureProcess( nullptr )
+	drag_distance_( 0 )
 {
 	scone::TimeSection( "CreateWindow" );
 	ui.setupUi( this );
@@ -134,6 +137,13 @@ SconeStudio::SconeStudio( QWidget* parent, Qt::WindowFlags flags ) :
 	connect( ui.playControl, &QPlayControl::sliderReleased, this, &SconeStudio::refreshAnalysis );
 	connect( analysisView, &QDataAnalysisView::timeChanged, ui.playControl, &QPlayControl::setTimeStop );
 
+	// real-time evaluation statistics, shown on top of the viewer
+	realTimeHud = new QLabel( ui.osgViewer );
+	realTimeHud->setStyleSheet( "QLabel { background-color : rgba(0, 0, 0, 128); color : white; padding : 4px; }" );
+	realTimeHud->setAttribute( Qt::WA_TransparentForMouseEvents );
+	realTimeHud->move( 8, 8 );
+	realTimeHud->hide();
+
 	// docking
 	setDockNestingEnabled( true );
 	setCorner( Qt::TopLeftCorner, Qt::LeftDockWidgetArea );
@@ -167,11 +177,11 @@ SconeStudio::SconeStudio( QWidget* parent, Qt::WindowFlags flags ) :
 	reportDock->hide();
 	scone::TimeSection( "InitEvaluationReport" );
 
-	// gait analysis
-	gaitAnalysis = new GaitAnalysis( this );
-	gaitAnalysisDock = createDockWidget( "&Gait Analysis", gaitAnalysis, Qt::BottomDockWidgetArea );
+	// gait analysis, the dock is created here to preserve the layout, its content when first shown
+	gaitAnalysisDock = createDockWidget( "&Gait Analysis", new QWidget( this ), Qt::BottomDockWidgetArea );
 	tabifyDockWidget( ui.messagesDock, gaitAnalysisDock );
 	gaitAnalysisDock->hide();
+	createOnFirstShow( gaitAnalysisDock, &SconeStudio::createGaitAnalysis );
 	scone::TimeSection( "InitGaitAnalysis" );
 
 	// parameter view
@@ -233,22 +243,25 @@ SconeStudio::SconeStudio( QWidget* parent, Qt::WindowFlags flags ) :
 #endif
 
 	// optimization history
-	optimizationHistoryView = new QDataAnalysisView( optimizationHistoryStorageModel, this );
-	optimizationHistoryView->setObjectName( "Optimization History" );
-	optimizationHistoryView->setAutoFitVerticalAxis( scone::GetStudioSettings().get<bool>( "analysis.auto_fit_vertical_axis" ) );
-	optimizationHistoryView->setLineWidth( scone::GetStudioSettings().get<float>( "analysis.line_width" ) );
-	optimizationHistoryDock = createDockWidget( "Optimization &History", optimizationHistoryView, Qt::BottomDockWidgetArea );
+	optimizationHistoryDock = createDockWidget( "Optimization &History", new QWidget( this ), Qt::BottomDockWidgetArea );
 	tabifyDockWidget( ui.messagesDock, optimizationHistoryDock );
 	optimizationHistoryDock->hide();
+	createOnFirstShow( optimizationHistoryDock, &SconeStudio::createOptimizationHistory );
 
 	// Muscle plot
-	muscleAnalysis = new MuscleAnalysis( this );
-	muscleAnalysisDock = createDockWidget( "Muscle Ana&lysis", muscleAnalysis, Qt::BottomDockWidgetArea );
+	muscleAnalysisDock = createDockWidget( "Muscle Ana&lysis", new QWidget( this ), Qt::BottomDockWidgetArea );
 	tabifyDockWidget( ui.messagesDock, muscleAnalysisDock );
 	muscleAnalysisDock->hide();
-	connect( muscleAnalysis, &MuscleAnalysis::dofChanged, this,
-		[this]( const QString& d ) { if ( hasModel() ) muscleAnalysis->setDof( scenario_->GetModel(), d ); } );
-	connect( muscleAnalysis, &MuscleAnalysis::dofValueChanged, this, &SconeStudio::muscleAnalysisValueChanged );
+	createOnFirstShow( muscleAnalysisDock, &SconeStudio::createMuscleAnalysis );
+
+	// results catalog
+	resultsCatalogDock = createDockWidget( "Results &Catalog", new QWidget( this ), Qt::LeftDockWidgetArea );
+	tabifyDockWidget( ui.resultsDock, resultsCatalogDock );
+	resultsCatalogDock->hide();
+	createOnFirstShow( resultsCatalogDock, &SconeStudio::createResultsCatalog );
+	connect( resultsCatalogDock, &QDockWidget::visibilityChanged, this, [this]( bool visible ) {
+		if ( visible ) { resultsCatalog->indexResultsFolder( to_qt( GetFolder( SconeFolder::Results ) ) ); resultsCatalog->refresh(); } } );
+	scone::TimeSection( "InitOtherDocks" );
 
 	//
 	// Menu
@@ -367,7 +380,8 @@ SconeStudio::SconeStudio( QWidget* parent, Qt::WindowFlags flags ) :
 	toolsMenu->addAction( "Clear Analysis Fi&lter", [this]() { analysisView->setFilterText( "" ); analysisView->selectNone();
 	analysisDock->raise(); analysisView->focusFilterEdit(); }, QKeySequence( "Ctrl+Shift+L" ) );
 	toolsMenu->addAction( "&Keep Current Analysis Graphs", analysisView, &QDataAnalysisView::holdSeries, QKeySequence( "Ctrl+Shift+K" ) );
-	toolsMenu->addAction( "Refresh Muscle Analysis", muscleAnalysis, &MuscleAnalysis::refresh, QKeySequence( "Ctrl+Shift+M" ) );
+	toolsMenu->addAction( "Refresh Muscle Analysis", [this]() { if ( muscleAnalysis ) muscleAnalysis->refresh(); }, QKeySequence( "Ctrl+Shift+M" ) );
+	toolsMenu->addAction( "Export Profiler &Trace...", this, &SconeStudio::exportProfilerTrace );
 	toolsMenu->addSeparator();
 #if SCONE_HYFYDY_ENABLED
 	toolsMenu->addAction( "&Convert to Hyfydy...", this, &SconeStudio::convertScenario );
@@ -443,9 +457,15 @@ SconeStudio::SconeStudio( QWidget* parent, Qt::WindowFlags flags ) :
 bool SconeStudio::init()
 {
 	// add outputText to global sinks (only *after* the ui has been initialized)
-	xo::log::add_sink( ui.outputText );
-	ui.outputText->set_sink_mode( xo::log::sink_mode::current_thread );
-	ui.outputText->set_log_level( xo::log::level( GetStudioSetting<int>( "ui.log_level" ) ) );
+	// messages are queued and appended in batches, once per frame
+	auto log_level = xo::log::level( GetStudioSetting<int>( "ui.log_level" ) );
+	ui.outputText->set_log_level( log_level );
+	outputSink = std::make_unique< scone::AsyncLogSink >( *ui.outputText, log_level, false );
+	connect( &outputUpdateTimer, &QTimer::timeout, this, [this]() { outputSink->flush(); } );
+	outputUpdateTimer.start( int( 1000 / QGuiApplication::primaryScreen()->refreshRate() ) );
+
+	// record profiler scopes for Export Profiler Trace
+	GetTraceRecorder().setEnabled( GetStudioSetting<bool>( "ui.enable_profiler" ) );
 
 	// see if this is a new version of SCONE
 	auto version = xo::to_str( scone::GetSconeVersion() );
@@ -458,8 +478,9 @@ bool SconeStudio::init()
 		checkTutorials |= GetStudioSetting<bool>( "ui.check_tutorials_new_version" );
 	}
 
+	// compare tutorials in the background, only prompt the user when something needs updating
 	if ( checkTutorials )
-		scone::updateTutorialsExamples();
+		tutorialsCheck = std::async( std::launch::async, &scone::checkTutorialsExamples );
 
 	ui.messagesDock->raise();
 
@@ -467,6 +488,7 @@ bool SconeStudio::init()
 	backgroundUpdateTimer.start( GetStudioSetting<int>( "progress.update_interval" ) );
 
 	QObject::connect( &fileWatcher, SIGNAL( fileChanged( const QString& ) ), this, SLOT( handleFileChanged( const QString& ) ) );
+	connect( &processPool, &ProcessPool::statusChanged, this, &SconeStudio::updateProcessStatus );
 
 	QTimer::singleShot( 0, this, SLOT( windowShown() ) );
 
@@ -503,13 +525,81 @@ void SconeStudio::windowShown()
 {
 	if ( scone::GetStudioSetting<bool>( "ui.show_startup_time" ) ) {
 		scone::TimeSection( "FinalShown" );
-		log::info( scone::GetStudioStopwatch().get_report() );
+		log::info( scone::GetStartupReport() );
+	}
+}
+
+void SconeStudio::createOnFirstShow( QDockWidget* dock, void ( SconeStudio::* create )() )
+{
+	// this also triggers when a dock is shown while restoring the saved layout
+	connect( dock, &QDockWidget::visibilityChanged, this, [this, create]( bool visible ) { if ( visible ) ( this->*create )(); } );
+}
+
+static void replaceDockContent( QDockWidget* dock, QWidget* widget )
+{
+	auto* placeholder = dock->widget();
+	dock->setWidget( widget );
+	delete placeholder;
+}
+
+void SconeStudio::createGaitAnalysis()
+{
+	if ( !gaitAnalysis ) {
+		STUDIO_PROFILE_FUNCTION;
+		gaitAnalysis = new GaitAnalysis( this );
+		replaceDockContent( gaitAnalysisDock, gaitAnalysis );
+	}
+}
+
+void SconeStudio::createMuscleAnalysis()
+{
+	if ( !muscleAnalysis ) {
+		STUDIO_PROFILE_FUNCTION;
+		muscleAnalysis = new MuscleAnalysis( this );
+		replaceDockContent( muscleAnalysisDock, muscleAnalysis );
+		connect( muscleAnalysis, &MuscleAnalysis::dofChanged, this,
+			[this]( const QString& d ) { if ( hasModel() ) muscleAnalysis->setDof( scenario_->GetModel(), d ); } );
+		connect( muscleAnalysis, &MuscleAnalysis::dofValueChanged, this, &SconeStudio::muscleAnalysisValueChanged );
+		if ( hasModel() ) {
+			muscleAnalysis->init( scenario_->GetModel() );
+			muscleAnalysis->setEnableEditing( scenario_->IsEvaluatingStart() );
+		}
+	}
+}
+
+void SconeStudio::createOptimizationHistory()
+{
+	if ( !optimizationHistoryView ) {
+		STUDIO_PROFILE_FUNCTION;
+		optimizationHistoryView = new QDataAnalysisView( optimizationHistoryStorageModel, this );
+		optimizationHistoryView->setObjectName( "Optimization History" );
+		optimizationHistoryView->setAutoFitVerticalAxis( scone::GetStudioSettings().get<bool>( "analysis.auto_fit_vertical_axis" ) );
+		optimizationHistoryView->setLineWidth( scone::GetStudioSettings().get<float>( "analysis.line_width" ) );
+		replaceDockContent( optimizationHistoryDock, optimizationHistoryView );
+		if ( !optimizationHistoryStorage.IsEmpty() ) {
+			optimizationHistoryView->reloadData();
+			optimizationHistoryView->setRange( 0, optimizationHistoryStorage.Back().GetTime() );
+		}
+	}
+}
+
+void SconeStudio::createResultsCatalog()
+{
+	if ( !resultsCatalog ) {
+		STUDIO_PROFILE_FUNCTION;
+		resultsCatalog = new ResultsCatalog( this );
+		replaceDockContent( resultsCatalogDock, resultsCatalog );
+		connect( resultsCatalog, &ResultsCatalog::resultActivated, this, [this]( const QString& dir ) { activateResult( QFileInfo( dir ) ); } );
 	}
 }
 
 void SconeStudio::activateBrowserItem( QModelIndex idx )
 {
-	auto fi = ui.resultsBrowser->fileSystemModel()->fileInfo( idx );
+	activateResult( ui.resultsBrowser->fileSystemModel()->fileInfo( idx ) );
+}
+
+void SconeStudio::activateResult( QFileInfo fi )
+{
 	if ( fi.isDir() )
 		fi = scone::findBestPar( QDir( fi.absoluteFilePath() ) );
 
@@ -575,6 +665,8 @@ void SconeStudio::stop()
 {
 	if ( real_time_evaluation_enabled_ ) {
 		real_time_evaluation_enabled_ = false;
+		if ( realTimeEvaluator )
+			finishRealTimeEvaluation();
 		if ( scenario_ && scenario_->IsEvaluating() )
 			scenario_->AbortEvaluation();
 		if ( scenario_->HasData() )
@@ -588,7 +680,7 @@ void SconeStudio::stop()
 
 void SconeStudio::refreshAnalysis()
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	analysisView->setTime( current_time );
 }
@@ -633,12 +725,13 @@ void SconeStudio::muscleAnalysisValueChanged( const QString& dof, double value )
 
 void SconeStudio::evaluate()
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 	SCONE_ASSERT( scenario_ );
 
 	// disable dof editor and model input editor
 	dofEditor->setEnableEditing( false );
-	muscleAnalysis->setEnableEditing( false );
+	if ( muscleAnalysis )
+		muscleAnalysis->setEnableEditing( false );
 #if SCONE_EXPERIMENTAL_FEATURES_ENABLED
 	userInputEditor->setEnableEditing( false );
 #endif
@@ -699,37 +792,14 @@ void SconeStudio::evaluateOffline()
 	log::info( "Evaluation took ", real_dur, "s for ", sim_time, "s (", sim_time / real_dur, "x real-time)" );
 }
 
-void SconeStudio::evaluateRealTime()
-{
-	auto max_time = scenario_->GetMaxTime() > 0 ? scenario_->GetMaxTime() : 60.0;
-	auto slomo = ui.playControl->slowMotionFactor();
-
-	xo::timer timer;
-	while ( scenario_->IsEvaluating() )
-	{
-		auto t = slomo * timer().secondsd();
-		if ( t - scenario_->GetTime() > max_real_time_evaluation_step_ ) {
-			t = scenario_->GetTime() + max_real_time_evaluation_step_;
-			timer.set( xo::time_from_seconds( t ) / slomo );
-		}
-
-		setTime( t );
-		updateVisualization();
-		ui.progressBar->setValue( std::min( int( 1000 * t / max_time ), 1000 ) );
-		QApplication::processEvents();
-
-		if ( ui.abortButton->isChecked() )
-			scenario_->AbortEvaluation();
-	}
-}
-
 void SconeStudio::startRealTimeEvaluation()
 {
 	SCONE_ASSERT( scenario_ );
 
 	// disable dof editor and model input editor
 	dofEditor->setEnableEditing( false );
-	muscleAnalysis->setEnableEditing( false );
+	if ( muscleAnalysis )
+		muscleAnalysis->setEnableEditing( false );
 #if SCONE_EXPERIMENTAL_FEATURES_ENABLED
 	userInputEditor->setEnableEditing( false );
 #endif
@@ -737,9 +807,58 @@ void SconeStudio::startRealTimeEvaluation()
 	real_time_evaluation_enabled_ = true;
 	auto max_time = scenario_->GetMaxTime() > 0 ? scenario_->GetMaxTime() : 60.0;
 	ui.playControl->setRange( 0.0, max_time );
+
+	// the simulation runs in its own thread, playback only updates the visualization
+	realTimeEvaluator = std::make_unique< scone::RealTimeEvaluator >( *scenario_, ui.playControl->slowMotionFactor(), max_real_time_evaluation_step_ );
+	realTimeFrameTimer = xo::timer();
+	realTimeFrameTime = 0.0;
+	realTimeFrameInterval = 1.0;
+	realTimeDroppedFrames = 0;
+	interactionLatencySum = interactionLatencyMax = 0.0;
+	interactionLatencyCount = 0;
+	realTimeHud->show();
 	ui.playControl->play();
 }
 
+void SconeStudio::finishRealTimeEvaluation()
+{
+	realTimeEvaluator->stop();
+	log::info( "Real-time evaluation stopped at ", realTimeEvaluator->simTime(), "s; dropped_frames=", realTimeDroppedFrames,
+		" clamped_steps=", realTimeEvaluator->clampedSteps() );
+	if ( interactionLatencyCount > 0 )
+		log::info( "Interaction latency: mean=", 1000 * interactionLatencySum / interactionLatencyCount, "ms max=", 1000 * interactionLatencyMax, "ms" );
+	auto error_message = realTimeEvaluator->errorMessage();
+	realTimeEvaluator.reset();
+	realTimeHud->hide();
+
+	// finalize on the GUI thread, because this may show message boxes
+	if ( scenario_ && scenario_->IsEvaluating() ) {
+		if ( !error_message.empty() )
+			scenario_->AbortEvaluation( error_message );
+		else if ( scenario_->GetModel().HasSimulationEnded() )
+			scenario_->EvaluateTo( scenario_->GetTime() );
+	}
+}
+
+void SconeStudio::updateRealTimeHud()
+{
+	// frames are dropped when the interval exceeds the playback interval, which is limited by the refresh rate
+	auto t = realTimeFrameTimer().secondsd();
+	auto dt = t - realTimeFrameTime;
+	realTimeFrameTime = t;
+	auto refresh_interval = 1.0 / QGuiApplication::primaryScreen()->refreshRate();
+	realTimeFrameInterval = std::max( refresh_interval, std::min( realTimeFrameInterval, dt ) );
+	realTimeDroppedFrames += std::max( 0, int( dt / realTimeFrameInterval + 0.5 ) - 1 );
+
+	auto text = QString::asprintf( "Real-time factor: %.2fx\nSimulation lag: %.0f ms\nDropped frames: %d\nClamped steps: %d",
+		realTimeEvaluator->realTimeFactor(), 1000 * realTimeEvaluator->lag(), realTimeDroppedFrames, realTimeEvaluator->clampedSteps() );
+	if ( interactionLatencyCount > 0 )
+		text += QString::asprintf( "\nInput latency: %.0f ms (max %.0f ms)",
+			1000 * interactionLatencySum / interactionLatencyCount, 1000 * interactionLatencyMax );
+	realTimeHud->setText( text );
+	realTimeHud->adjustSize();
+}
+
 void SconeStudio::modelAnalysis()
 {
 	if ( scenario_ && scenario_->HasModel() )
@@ -748,11 +867,12 @@ void SconeStudio::modelAnalysis()
 
 void SconeStudio::updateGaitAnalysis()
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	try {
 		if ( scenario_ && !scenario_->IsEvaluating() )
 		{
+			createGaitAnalysis();
 			gaitAnalysis->update( scenario_->GetData(), scenario_->GetFileName() );
 			gaitAnalysisDock->setWindowTitle( gaitAnalysis->info() );
 			gaitAnalysisDock->show();
@@ -764,23 +884,25 @@ void SconeStudio::updateGaitAnalysis()
 
 void SconeStudio::setTime( TimeInSeconds t )
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	if ( scenario_ )
 	{
 		// advance simulation
 		if ( scenario_->IsEvaluating() ) {
-			if ( real_time_evaluation_enabled_ ) {
-				if ( t - scenario_->GetTime() > max_real_time_evaluation_step_ ) {
-					t = scenario_->GetTime() + max_real_time_evaluation_step_;
-					ui.playControl->adjustCurrentTime( t );
-				}
+			if ( realTimeEvaluator ) {
+				// the simulation is advanced by the real-time evaluator, playback follows
+				realTimeEvaluator->setSlowMotionFactor( ui.playControl->slowMotionFactor() );
+				current_time = realTimeEvaluator->simTime();
+				ui.playControl->adjustCurrentTime( current_time );
+				updateRealTimeHud();
+				if ( realTimeEvaluator->isFinished() )
+					ui.playControl->stop(); // stop triggers real-time evaluation handling
+			}
+			else {
+				scenario_->EvaluateTo( t );
+				current_time = scenario_->GetTime();
 			}
-			scenario_->EvaluateTo( t );
-			current_time = scenario_->GetTime();
-
-			if ( real_time_evaluation_enabled_ && scenario_->IsFinished() )
-				ui.playControl->stop(); // stop triggers real-time evaluation handling
 		}
 		else current_time = t;
 	}
@@ -791,8 +913,13 @@ void SconeStudio::updateVisualization()
 	// update UI and visualization
 	if ( scenario_ && scenario_->HasModel() )
 	{
-		// update 3D viewer
-		scenario_->UpdateVis( current_time );
+		auto lock = realTimeEvaluator ? realTimeEvaluator->lock() : std::unique_lock<std::mutex>();
+
+		// update 3D viewer, offscreen renderers may be updating scenes at the same time
+		{
+			std::scoped_lock vis_lock( scone::OffscreenRenderer::visMutex() );
+			scenario_->UpdateVis( current_time );
+		}
 		if ( !scenario_->GetViewOptions().get<ViewOption::StaticCamera>() ) {
 			auto fp = vis::to_osg( scenario_->GetFollowPoint() );
 			if ( scenario_->GetViewOptions().get<ViewOption::FollowCamera>() )
@@ -802,6 +929,16 @@ void SconeStudio::updateVisualization()
 		scenario_->SetVisFocusPoint( scone::Vec3( ui.osgViewer->getCameraMan().getFocusPoint() ) );
 		ui.osgViewer->setFrameTime( current_time );
 
+		// measure latency from mouse event to the first frame that shows its response
+		if ( auto t = scenario_->TakeInteractionTime() ) {
+			auto latency = std::chrono::duration<double>( std::chrono::steady_clock::now() - *t ).count();
+			interactionLatencySum += latency;
+			interactionLatencyMax = std::max( interactionLatencyMax, latency );
+			++interactionLatencyCount;
+			if ( GetTraceRecorder().enabled() )
+				GetTraceRecorder().record( "InteractionLatency", "interaction", GetTraceRecorder().toTraceTime( *t ) );
+		}
+
 		// update UI elements
 		if ( analysisView->isVisible() ) // #todo: isVisible() returns true if the tab is hidden
 			analysisView->setTime( current_time, !ui.playControl->isPlaying() );
@@ -992,7 +1129,7 @@ void SconeStudio::addProgressDock( ProgressDockWidget* pdw )
 
 void SconeStudio::clearScenario()
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	// remove files from watcher
 	if ( scenario_ )
@@ -1002,17 +1139,20 @@ void SconeStudio::clearScenario()
 	ui.playControl->stop();
 	analysisStorageModel.setStorage( nullptr );
 	parModel->setObjectiveInfo( nullptr );
-	gaitAnalysis->reset();
+	if ( gaitAnalysis )
+		gaitAnalysis->reset();
 	parViewDock->setWindowTitle( "Parameters" );
 	ui.playControl->setRange( 0, 0 );
 	optimizationHistoryStorage.Clear();
-	muscleAnalysis->clear();
+	if ( muscleAnalysis )
+		muscleAnalysis->clear();
+	realTimeEvaluator.reset();
 	scenario_.reset();
 }
 
 bool SconeStudio::createScenario( const QString& any_file )
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	clearScenario();
 
@@ -1033,11 +1173,13 @@ bool SconeStudio::createScenario( const QString& any_file )
 			dofEditor->setEnableEditing( scenario_->IsEvaluatingStart() );
 
 			// setup muscle plots
-			muscleAnalysis->init( scenario_->GetModel() );
-			muscleAnalysis->setEnableEditing( scenario_->IsEvaluatingStart() );
-			if ( muscleAnalysis->isVisible() && scenario_->GetFileType() == "scone"
-				&& scone::GetStudioSetting<bool>( "muscle_analysis.analyze_on_load" ) )
-				muscleAnalysis->refresh(); // this may affect evaluation result, use with care
+			if ( muscleAnalysis ) {
+				muscleAnalysis->init( scenario_->GetModel() );
+				muscleAnalysis->setEnableEditing( scenario_->IsEvaluatingStart() );
+				if ( muscleAnalysis->isVisible() && scenario_->GetFileType() == "scone"
+					&& scone::GetStudioSetting<bool>( "muscle_analysis.analyze_on_load" ) )
+					muscleAnalysis->refresh(); // this may affect evaluation result, use with care
+			}
 
 			// set data, in case the file was an sto
 			if ( scenario_->HasData() )
@@ -1080,8 +1222,10 @@ bool SconeStudio::createScenario( const QString& any_file )
 				if ( !optimizationHistoryStorage.IsEmpty() )
 				{
 					optimizationHistoryStorageModel.setStorage( &optimizationHistoryStorage );
-					optimizationHistoryView->reloadData();
-					optimizationHistoryView->setRange( 0, optimizationHistoryStorage.Back().GetTime() );
+					if ( optimizationHistoryView ) {
+						optimizationHistoryView->reloadData();
+						optimizationHistoryView->setRange( 0, optimizationHistoryStorage.Back().GetTime() );
+					}
 				}
 			}
 			catch ( std::exception& e ) {
@@ -1198,7 +1342,7 @@ QCodeEditor* SconeStudio::getActiveScenario()
 
 bool SconeStudio::createAndVerifyActiveScenario( bool always_create, bool must_have_parameters )
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	if ( auto* s = getActiveScenario() )
 	{
@@ -1254,7 +1398,7 @@ void SconeStudio::updateEvaluationReport()
 
 void SconeStudio::updateModelDataWidgets()
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 	SCONE_ASSERT( scenario_ && scenario_->HasData() );
 
 	analysisStorageModel.setStorage( &scenario_->GetData() );
@@ -1288,13 +1432,22 @@ void SconeStudio::optimizeScenarioMultiple()
 			int count = QInputDialog::getInt( this, "Run Multiple Optimizations", "Enter number of optimization instances: ", 3, 1, 100, 1, &ok );
 			if ( ok )
 			{
+				// optimizations exceeding the concurrency limit are started when others finish
+				auto max_concurrent = GetStudioSetting<int>( "optimization.max_concurrent_optimizations" );
 				for ( int i = 1; i <= count; ++i )
 				{
 					QStringList args( QString( "#1.random_seed=%1" ).arg( i ) );
+					if ( max_concurrent > 0 && i > max_concurrent )
+					{
+						queuedOptimizations.emplace_back( scenario_->GetScenarioFileName(), args );
+						continue;
+					}
 					auto task = createOptimizerTask( scenario_->GetScenarioFileName(), args );
 					addProgressDock( new ProgressDockWidget( this, std::move( task ) ) );
 					QApplication::processEvents(); // needed for the ProgressDockWidgets to be evenly sized
 				}
+				if ( !queuedOptimizations.empty() )
+					log::info( "Queued ", queuedOptimizations.size(), " optimizations, running at most ", max_concurrent, " at the same time" );
 				updateOptimizations();
 			}
 		}
@@ -1399,6 +1552,9 @@ bool SconeStudio::abortOptimizations()
 
 		if ( !showWarning || QMessageBox::warning( this, "Abort Optimizations", message, QMessageBox::Abort, QMessageBox::Cancel ) == QMessageBox::Abort )
 		{
+			if ( !queuedOptimizations.empty() )
+				log::info( "Removed ", queuedOptimizations.size(), " queued optimizations" );
+			queuedOptimizations.clear();
 			for ( const auto& o : optimizations )
 			{
 				o->disableCloseWarning();
@@ -1413,14 +1569,19 @@ bool SconeStudio::abortOptimizations()
 
 void SconeStudio::updateBackgroundTimer()
 {
-	GUI_PROFILE_FUNCTION;
+	STUDIO_PROFILE_FUNCTION;
 
 	if ( !ui.playControl->isPlaying() )
 		updateOptimizations();
 	if ( scenario_ )
 		scenario_->CheckWriteResults();
 	handleAutoReload();
-	checkActiveProcesses();
+
+	if ( tutorialsCheck.valid() && tutorialsCheck.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready ) {
+		if ( tutorialsCheck.get() )
+			scone::updateTutorialsExamples();
+		else log::info( "SCONE Tutorials and Examples are up-to-date" );
+	}
 }
 
 void SconeStudio::handleAutoReload()
@@ -1441,45 +1602,20 @@ void SconeStudio::handleAutoReload()
 	}
 }
 
-void SconeStudio::checkActiveProcesses()
+void SconeStudio::updateProcessStatus()
 {
-	if ( activeProcesses.empty() && queuedProcesses.empty() )
-		return;
-
-	// handle running processes
-	auto it = activeProcesses.begin();
-	while ( it != activeProcesses.end() ) {
-		auto& p = **it;
-		if ( p.state() != QProcess::Running ) {
-			p.waitForFinished();
-			p.close();
-			it = activeProcesses.erase( it );
-		}
-		else {
-			if ( p.waitForReadyRead( 0 ) )
-				xo::log::debug( p.readAll().toStdString() );
-			it++;
-		}
-	}
-
-	// start new processes
-	auto max_process_count = GetStudioSetting<size_t>( "sconegym.max_concurrent_evaluations" );
-	if ( max_process_count == 0 )
-		max_process_count = std::thread::hardware_concurrency() / 2;
-	while ( activeProcesses.size() < max_process_count && queuedProcesses.size() > 0 ) {
-		activeProcesses.emplace_back( std::move( queuedProcesses.front() ) );
-		queuedProcesses.erase( queuedProcesses.begin() );
-		startProcess( *activeProcesses.back() );
-	}
-
-	// update status bar
-	if ( activeProcesses.size() > 0 || queuedProcesses.size() > 0 ) {
-		QString msg = QString( "Number of active background processes: %1" ).arg( activeProcesses.size() );
-		if ( queuedProcesses.size() > 0 )
-			msg += QString( " (%1 queued)" ).arg( queuedProcesses.size() );
+	// called by the process pool each time a process is started or finished, and after each CPU time sample
+	if ( processPool.activeCount() > 0 || processPool.queuedCount() > 0 ) {
+		QString msg = QString( "Number of active background processes: %1" ).arg( processPool.activeCount() );
+		if ( processPool.queuedCount() > 0 )
+			msg += QString( " (%1 queued)" ).arg( processPool.queuedCount() );
 		ui.statusBar->showMessage( msg );
+		ui.statusBar->setToolTip( processPool.statusText() );
+	}
+	else {
+		ui.statusBar->showMessage( "All background processes have finished", 3000 );
+		ui.statusBar->setToolTip( QString() );
 	}
-	else ui.statusBar->showMessage( "All background processes have finished", 3000 );
 }
 
 void SconeStudio::updateOptimizations()
@@ -1508,6 +1644,67 @@ void SconeStudio::updateOptimizations()
 			return; // must return here because close invalidates the iterator
 		}
 	}
+
+	if ( GetStudioSetting<bool>( "optimization.racing_enabled" ) )
+		updateOptimizationRacing();
+
+	if ( !queuedOptimizations.empty() )
+		startQueuedOptimizations();
+}
+
+void SconeStudio::startQueuedOptimizations()
+{
+	auto max_concurrent = GetStudioSetting<int>( "optimization.max_concurrent_optimizations" );
+	auto running = std::count_if( optimizations.begin(), optimizations.end(), []( auto* o ) { return o->isRunning(); } );
+	while ( !queuedOptimizations.empty() && ( max_concurrent <= 0 || running < max_concurrent ) )
+	{
+		auto [scenario_file, args] = queuedOptimizations.front();
+		queuedOptimizations.pop_front();
+		log::info( "Starting queued optimization ", scenario_file.toStdString(), " ", args.join( ' ' ).toStdString() );
+		addProgressDock( new ProgressDockWidget( this, createOptimizerTask( scenario_file, args ) ) );
+		++running;
+	}
+}
+
+void SconeStudio::updateOptimizationRacing()
+{
+	const auto min_gens = GetStudioSetting<int>( "optimization.racing_min_generations" );
+	const auto margin = GetStudioSetting<float>( "optimization.racing_margin" );
+
+	// optimizations of the same scenario race against each other
+	std::map< QString, std::vector< ProgressDockWidget* > > races;
+	for ( auto* o : optimizations )
+		if ( !o->isStopped && o->best_idx != -1 )
+			races[ o->task_->scenario_file_ ].push_back( o );
+
+	for ( auto& [scenario_file, docks] : races )
+	{
+		if ( docks.size() < 2 )
+			continue;
+
+		// the leader is the optimization with the best fitness so far, running or finished
+		auto leader_it = std::min_element( docks.begin(), docks.end(), []( auto* a, auto* b ) {
+			const auto& oa = a->optimizations[ a->best_idx ];
+			const auto& ob = b->optimizations[ b->best_idx ];
+			return oa.is_minimizing ? oa.best < ob.best : oa.best > ob.best; } );
+		const auto& leader = ( *leader_it )->optimizations[ ( *leader_it )->best_idx ];
+		const auto threshold = leader.is_minimizing ? leader.best + margin * std::abs( leader.best ) : leader.best - margin * std::abs( leader.best );
+
+		// stop running optimizations whose predicted fitness is dominated by the leader
+		for ( auto* d : docks )
+		{
+			const auto& o = d->optimizations[ d->best_idx ];
+			if ( d == *leader_it || !d->isRunning() || o.cur_gen < min_gens )
+				continue;
+			bool dominated = leader.is_minimizing ? o.cur_pred > threshold : o.cur_pred < threshold;
+			if ( dominated )
+			{
+				log::info( "Stopping optimization ", o.name, " at generation ", o.cur_gen, ": predicted fitness ", o.cur_pred,
+					" is dominated by ", leader.name, " (best=", leader.best, " margin=", margin, ")" );
+				d->stopOptimization();
+			}
+		}
+	}
 }
 
 void SconeStudio::tabCloseRequested( int idx )
@@ -1548,8 +1745,13 @@ void SconeStudio::applyViewOptions()
 void SconeStudio::showSettingsDialog()
 {
 	if ( ShowPreferencesDialog( this ) == QDialog::Accepted ) {
-		gaitAnalysis->reset();
-		ui.outputText->set_log_level( xo::log::level( GetStudioSetting<int>( "ui.log_level" ) ) );
+		if ( gaitAnalysis )
+			gaitAnalysis->reset();
+		auto log_level = xo::log::level( GetStudioSetting<int>( "ui.log_level" ) );
+		ui.outputText->set_log_level( log_level );
+		if ( outputSink )
+			outputSink->set_log_level( log_level );
+		GetTraceRecorder().setEnabled( GetStudioSetting<bool>( "ui.enable_profiler" ) );
 		initViewerSettings();
 	}
 }
@@ -1617,18 +1819,31 @@ void SconeStudio::viewerSelect()
 	}
 }
 
+void SconeStudio::pushInteraction( const scone::InteractionInput& input )
+{
+	// the real-time evaluator applies inputs before each simulation step, otherwise apply directly
+	scenario_->PushInteraction( input );
+	if ( !realTimeEvaluator )
+		scenario_->ApplyInteractions();
+}
+
 void SconeStudio::viewerMousePush()
 {
+	STUDIO_PROFILE_FUNCTION;
+
 	if ( scenario_ && scenario_->IsEvaluating() && scenario_->HasModel() ) {
-		if ( auto* spr = scenario_->GetModel().GetInteractionSpring() ) {
+		if ( scenario_->GetModel().GetInteractionSpring() ) {
 			for ( auto& intersection : ui.osgViewer->getIntersections() ) {
 				for ( auto it = intersection.nodePath.rbegin(); it != intersection.nodePath.rend(); it++ ) {
-					if ( auto* b = TryFindPtrByName( scenario_->GetModel().GetBodies(), ( *it )->getName() ) ) {
+					if ( auto* b = scenario_->TryFindBody( ( *it )->getName() ) ) {
 						if ( !b->IsStatic() ) {
-							const auto world_pos = Vec3( vis::from_osg( intersection.getWorldIntersectPoint() ) );
-							auto body_pos = b->GetLocalPosOfPoint( world_pos );
-							spr->SetParent( scenario_->GetModel().GetGroundBody(), world_pos );
-							spr->SetChild( *b, body_pos );
+							// the local position is computed from the body node as it is shown, because the
+							// simulation may have advanced by the time the interaction is applied
+							auto body_node = std::find_if( intersection.nodePath.begin(), it.base(), [b]( osg::Node* n ) { return n->getName() == b->GetName(); } );
+							const auto world_point = intersection.getWorldIntersectPoint();
+							const auto world_pos = Vec3( vis::from_osg( world_point ) );
+							const auto local_pos = Vec3( vis::from_osg( world_point * osg::computeWorldToLocal( osg::NodePath( intersection.nodePath.begin(), body_node + 1 ) ) ) );
+							pushInteraction( { InteractionInput::Type::Attach, b, world_pos, local_pos } );
 							drag_distance_ = xo::distance( world_pos, Vec3( ui.osgViewer->getMouseRay().pos ) );
 							ui.osgViewer->getCameraMan().setEnableCameraManipulation( false );
 							return;
@@ -1643,11 +1858,9 @@ void SconeStudio::viewerMousePush()
 void SconeStudio::viewerMouseDrag()
 {
 	if ( scenario_ && scenario_->IsEvaluating() && scenario_->HasModel() ) {
-		if ( auto* spr = scenario_->GetModel().GetInteractionSpring() ) {
-			auto p = spr->GetParentPos();
+		if ( scenario_->GetModel().GetInteractionSpring() ) {
 			auto mr = ui.osgViewer->getMouseRay();
-			auto p_new = Vec3( mr.pos + drag_distance_ * mr.dir );
-			spr->SetParent( scenario_->GetModel().GetGroundBody(), p_new );
+			pushInteraction( { InteractionInput::Type::Move, nullptr, Vec3( mr.pos + drag_distance_ * mr.dir ) } );
 		}
 	}
 }
@@ -1655,11 +1868,26 @@ void SconeStudio::viewerMouseDrag()
 void SconeStudio::viewerMouseRelease()
 {
 	if ( scenario_ && scenario_->HasModel() )
-		if ( auto* spr = scenario_->GetModel().GetInteractionSpring() )
-			spr->SetChild( scenario_->GetModel().GetGroundBody(), Vec3::zero() );
+		if ( scenario_->GetModel().GetInteractionSpring() )
+			pushInteraction( { InteractionInput::Type::Release } );
 	ui.osgViewer->getCameraMan().setEnableCameraManipulation( true );
 }
 
+void SconeStudio::exportProfilerTrace()
+{
+	if ( !GetTraceRecorder().enabled() && GetTraceRecorder().eventCount() == 0 ) {
+		information( "Export Profiler Trace", "No profiler events have been recorded.\n\nEnable the GUI profiler in Preferences to record events." );
+		return;
+	}
+	auto filename = QFileDialog::getSaveFileName( this, "Trace Filename", QString(), "Chrome trace files (*.json)" );
+	if ( !filename.isEmpty() )
+	{
+		if ( GetTraceRecorder().writeChromeTrace( path_from_qt( filename ) ) )
+			log::info( "Exported ", GetTraceRecorder().eventCount(), " profiler events to ", filename.toStdString() );
+		else error( "Error exporting profiler trace", "Could not write " + filename );
+	}
+}
+
 void SconeStudio::exportCoordinates()
 {
 	if ( scenario_ && scenario_->HasModel() )
@@ -1791,10 +2019,25 @@ void SconeStudio::createVideo()
 	if ( !captureFilename.contains( "." ) )
 		captureFilename += ".mp4"; // make sure filename has an extension (needed for Linux)
 
-	// start recording
-	QDir().mkdir( captureFilename + ".images" );
-	ui.osgViewer->startCapture( captureFilename.toStdString() + ".images/image" );
-
+	// start ffmpeg, frames are read back after rendering and streamed to its input
+	auto* camera = ui.osgViewer->getView( 0 )->getCamera();
+	scone::VideoEncoderSettings ves;
+	ves.ffmpeg = to_qt( GetStudioSetting<path>( "video.path_to_ffmpeg" ) );
+	ves.filename = captureFilename;
+	ves.width = int( camera->getViewport()->width() );
+	ves.height = int( camera->getViewport()->height() );
+	ves.frame_rate = GetStudioSetting<double>( "video.frame_rate" );
+	ves.quality = GetStudioSetting<int>( "video.quality" );
+	videoEncoder = std::make_unique<scone::VideoEncoder>( ves );
+	if ( !videoEncoder->waitForStarted() ) {
+		auto msg = videoEncoder->errorString();
+		videoEncoder.reset();
+		captureFilename.clear();
+		return error( "Could not start ffmpeg", msg );
+	}
+
+	const double frame_step = ui.playControl->slowMotionFactor() / ves.frame_rate;
+	captureFrameCount = int( scenario_->GetMaxTime() / frame_step ) + 1;
 	ui.osgViewer->startPlaybackMode();
 	ui.abortButton->setChecked( false );
 	ui.progressBar->setMaximum( 100 );
@@ -1802,15 +2045,23 @@ void SconeStudio::createVideo()
 	ui.progressBar->setFormat( "Creating Video (%p%)" );
 	ui.stackedWidget->setCurrentIndex( 1 );
 
-	const double frame_rate = GetStudioSettings().get<double>( "video.frame_rate" );
-	for ( double t = 0.0; t <= scenario_->GetMaxTime(); t += ui.playControl->slowMotionFactor() / frame_rate )
+	if ( GetStudioSetting<bool>( "video.offscreen_rendering" ) && scenario_->IsFinishedOrAborted() && scenario_->HasData() )
+		renderVideoOffscreen( frame_step );
+	else
 	{
-		setTime( t );
-		updateVisualization();
-		ui.progressBar->setValue( int( t / scenario_->GetMaxTime() * 100 ) );
-		QApplication::processEvents();
-		if ( ui.abortButton->isChecked() )
-			break;
+		// rendering blocks when ffmpeg falls behind, encoding overlaps with rendering
+		camera->setFinalDrawCallback( new scone::VideoCaptureCallback( *videoEncoder ) );
+		for ( int frame = 0; frame < captureFrameCount && !videoEncoder->isFinished(); ++frame )
+		{
+			setTime( frame * frame_step );
+			updateVisualization();
+			ui.osgViewer->repaint(); // render exactly one frame
+			updateCaptureProgress();
+			QApplication::processEvents();
+			if ( ui.abortButton->isChecked() )
+				break;
+		}
+		camera->setFinalDrawCallback( nullptr );
 	}
 
 	// finalize recording
@@ -1819,6 +2070,46 @@ void SconeStudio::createVideo()
 	ui.osgViewer->stopPlaybackMode();
 }
 
+void SconeStudio::renderVideoOffscreen( double frame_step )
+{
+	// frames of finished results are independent, render them in parallel using the current camera
+	auto* camera = ui.osgViewer->getView( 0 )->getCamera();
+	scone::OffscreenRenderSettings ors;
+	ors.width = videoEncoder->settings().width;
+	ors.height = videoEncoder->settings().height;
+	ors.frame_count = captureFrameCount;
+	ors.time_step = frame_step;
+	ors.reference_time = current_time;
+	ors.view_options = scenario_->GetViewOptions();
+	ors.view_matrix = camera->getViewMatrix();
+	ors.follow_body = GetStudioSetting<String>( "viewer.camera_follow_body" );
+	ors.projection_matrix = camera->getProjectionMatrix();
+	ors.clear_color = camera->getClearColor();
+	ors.ambient_intensity = GetStudioSetting<float>( "viewer.ambient_intensity" );
+	ors.threads = GetStudioSetting<int>( "video.render_threads" );
+
+	// the renderer copies the data, the scenario may be closed or reloaded while processing events
+	xo::timer render_time;
+	scone::OffscreenRenderer renderer( scenario_->GetFileName(), scenario_->GetData(), ors, *videoEncoder );
+	while ( !renderer.waitForFinished( 50 ) )
+	{
+		updateCaptureProgress();
+		QApplication::processEvents();
+		if ( ui.abortButton->isChecked() )
+			renderer.abort();
+	}
+
+	if ( auto msg = renderer.errorString(); !msg.isEmpty() )
+		error( "Error rendering video", msg );
+	else log::info( "Rendered ", renderer.framesRendered(), " frames in ", render_time().secondsd(), "s" );
+}
+
+void SconeStudio::updateCaptureProgress()
+{
+	if ( videoEncoder && captureFrameCount > 0 )
+		ui.progressBar->setValue( std::min( 100, 100 * videoEncoder->framesEncoded() / captureFrameCount ) );
+}
+
 void SconeStudio::captureImage()
 {
 	QString filename = QFileDialog::getSaveFileName( this, "Image Filename", QString(), "png files (*.png)" );
@@ -1828,45 +2119,28 @@ void SconeStudio::captureImage()
 
 void SconeStudio::setOrbitVelocity( float v )
 {
-	auto s = GetStudioSetting<vis::degree>( "viewer.camera_orbit_speed" );
+	auto s = vis::degree( GetStudioSettingsSnapshot().viewer.camera_orbit_speed );
 	ui.osgViewer->getCameraMan().setOrbitAnimation( v * s, vis::degree( 0 ), 0.0f );
 }
 
 void SconeStudio::finalizeCapture()
 {
-	ui.osgViewer->stopCapture();
-
-	const auto ffmpeg = GetStudioSetting<path>( "video.path_to_ffmpeg" );
-	if ( !xo::file_exists( ffmpeg ) )
-		return error( "Could not find ffmpeg", to_qt( "Could not find " + ffmpeg.str() ) );
-
-	QString program = to_qt( ffmpeg );
-	QStringList args;
-	args << "-r" << to_qt( GetStudioSettings().get<string>( "video.frame_rate" ) )
-		<< "-i" << captureFilename + ".images/image_0_%d.png"
-		<< "-c:v" << "mpeg4"
-		<< "-q:v" << to_qt( GetStudioSettings().get<string>( "video.quality" ) )
-		<< captureFilename;
-
-	std::cout << "starting " << program.toStdString() << std::endl;
-	auto v = args.toVector();
-	for ( auto arg : v )
-		std::cout << arg.toStdString() << std::endl;
-
-	captureProcess = new QProcess( this );
-	captureProcess->start( program, args );
-
-	xo_error_if( !captureProcess->waitForStarted( 5000 ), "Could not start process" );
-	scone::log::info( "Generating video for ", captureFilename.toStdString() );
+	if ( !videoEncoder )
+		return;
 
-	if ( !captureProcess->waitForFinished( 30000 ) )
-		scone::log::error( "Did not finish in time" );
+	// wait for ffmpeg to encode the remaining frames, without timeout and without blocking the GUI
+	videoEncoder->finish();
+	while ( !videoEncoder->waitForFinished( 50 ) ) {
+		updateCaptureProgress();
+		QApplication::processEvents();
+	}
 
-	scone::log::info( "Video generated" );
-	QDir( captureFilename + ".images" ).removeRecursively();
+	if ( auto msg = videoEncoder->errorString(); !msg.isEmpty() )
+		error( "Error creating video", msg );
+	else scone::log::info( "Generated ", captureFilename.toStdString(), "; frames=", videoEncoder->framesEncoded() );
 
-	delete captureProcess;
-	captureProcess = nullptr;
+	videoEncoder.reset();
+	captureFrameCount = 0;
 	captureFilename.clear();
 }
 
@@ -1913,7 +2187,15 @@ void SconeStudio::copyToScenarioFolder()
 	auto fileList = ui.resultsBrowser->selectedFiles();
 	auto scenario = getActiveScenario();
 	if ( fileList.size() >= 1 && scenario ) {
-		auto src_path = path_from_qt( fileList.front() );
+		// copy the best .par file when a result folder is selected
+		QFileInfo src_fi( fileList.front() );
+		if ( src_fi.isDir() )
+			src_fi = findBestPar( QDir( src_fi.absoluteFilePath() ) );
+		if ( !src_fi.isFile() ) {
+			information( "Copy to Scenario Folder", "Could not find a parameter file in:\n\n" + fileList.front() );
+			return;
+		}
+		auto src_path = path_from_qt( src_fi.absoluteFilePath() );
 		auto src_dir = src_path.parent_path().stem().str();
 		auto third_dot_idx = xo::find_nth_str( src_dir, ".", 3 );
 		auto trg_file = path( "par" ) / src_dir.substr( 0, third_dot_idx ) + "." + src_path.filename();
@@ -1930,13 +2212,62 @@ void SconeStudio::copyToScenarioFolder()
 void SconeStudio::evaluateSelectedFiles()
 {
 	auto fileList = ui.resultsBrowser->selectedFiles();
-	for ( const auto& f : fileList )
-		queuedProcesses.emplace_back( makeCheckpointProcess( f, this ) );
+	// output of each evaluation is written to a log file next to the checkpoint
+	for ( const auto& f : fileList ) {
+		QFileInfo fi( f );
+		processPool.enqueue( makeCheckpointProcess( f, this ), fi.dir().filePath( fi.completeBaseName() + "_evaluation.log" ) );
+	}
 
 	QString msg = "These files are being evaluated (see status bar for progress):\n\n";
 	information( "Evaluate .pt files", msg + makeFileListString( fileList, 10, 1 ) );
 }
 
+void SconeStudio::evaluateSelectedFilesInBackground()
+{
+	if ( batchEvaluation ) {
+		information( "Evaluate in Background", QString( "Please wait until the current background evaluation has finished (%1 of %2 files)" )
+			.arg( batchEvaluation->finishedCount() ).arg( batchEvaluation->fileCount() ) );
+		return;
+	}
+
+	auto fileList = ui.resultsBrowser->selectedFiles();
+	fileList.erase( std::remove_if( fileList.begin(), fileList.end(), []( const QString& f ) { return QFileInfo( f ).suffix() != "par"; } ), fileList.end() );
+	if ( fileList.empty() )
+		return;
+
+	log::info( "Evaluating ", fileList.size(), " files in the background" );
+	batchEvaluation = std::make_unique<BatchEvaluation>( fileList, GetStudioSetting<bool>( "file.background_evaluation_store_data" ) );
+	connect( batchEvaluation.get(), &BatchEvaluation::fileEvaluated, this, [this]( int finished, int total ) {
+		ui.statusBar->showMessage( QString( "Evaluated %1 of %2 files in the background" ).arg( finished ).arg( total ) ); }, Qt::QueuedConnection );
+	connect( batchEvaluation.get(), &BatchEvaluation::finished, this, &SconeStudio::finalizeBackgroundEvaluation, Qt::QueuedConnection );
+	batchEvaluation->start();
+}
+
+void SconeStudio::finalizeBackgroundEvaluation()
+{
+	if ( !batchEvaluation )
+		return;
+
+	// write summary next to the first evaluated file
+	const auto& results = batchEvaluation->results();
+	QFileInfo first( results.front().file );
+	auto summaryFile = first.dir().filePath( "evaluation_summary_" + QDateTime::currentDateTime().toString( "yyyyMMdd_hhmmss" ) + ".txt" );
+	int errors = int( std::count_if( results.begin(), results.end(), []( const BatchEvaluation::Result& r ) { return !r.error.empty(); } ) );
+	for ( const auto& r : results ) {
+		if ( r.error.empty() )
+			log::info( r.file.toStdString(), ": fitness=", r.fitness, " sim_time=", r.sim_time, " real_time=", r.real_time );
+		else log::error( r.file.toStdString(), ": ", r.error );
+	}
+
+	if ( batchEvaluation->writeSummary( summaryFile ) )
+		log::info( "Evaluation summary written to ", summaryFile.toStdString() );
+	else log::error( "Could not write ", summaryFile.toStdString() );
+	ui.statusBar->showMessage( QString( "Background evaluation finished (%1 errors)" ).arg( errors ), 5000 );
+
+	// worker threads are joined when the object is deleted
+	batchEvaluation.release()->deleteLater();
+}
+
 void SconeStudio::sortResultsByDate()
 {
 	ui.resultsBrowser->fileSystemModel()->sort( 3 );
@@ -1984,14 +2315,21 @@ void SconeStudio::onResultBrowserCustomContextMenu( const QPoint& pos )
 	menu.addAction( "Sort by Na&me", this, &SconeStudio::sortResultsByName );
 	menu.addAction( "Sort by &Date", this, &SconeStudio::sortResultsByDate );
 	menu.addSeparator();
-	if ( sel.size() == 1 && getActiveScenario() && ui.resultsBrowser->fileSystemModel()->fileInfo( sel.front() ).suffix() == "par" ) {
-		menu.addAction( "&Copy to Scenario Folder", this, &SconeStudio::copyToScenarioFolder );
-		menu.addSeparator();
+	if ( sel.size() == 1 ) {
+		auto fi = ui.resultsBrowser->fileSystemModel()->fileInfo( sel.front() );
+		if ( getActiveScenario() && ( fi.isDir() || fi.suffix() == "par" ) ) {
+			menu.addAction( "&Copy to Scenario Folder", this, &SconeStudio::copyToScenarioFolder );
+			menu.addSeparator();
+		}
 	}
 	if ( sel.size() >= 1 && ui.resultsBrowser->fileSystemModel()->fileInfo( sel.front() ).suffix() == "pt" ) {
 		menu.addAction( "&Evaluate", this, &SconeStudio::evaluateSelectedFiles );
 		menu.addSeparator();
 	}
+	if ( sel.size() >= 1 && ui.resultsBrowser->fileSystemModel()->fileInfo( sel.front() ).suffix() == "par" ) {
+		menu.addAction( "Evaluate in &Background", this, &SconeStudio::evaluateSelectedFilesInBackground );
+		menu.addSeparator();
+	}
 	if ( sel.size() >= 1 )
 		menu.addAction( "&Remove", this, &SconeStudio::deleteSelectedFileOrFolder );
 
@@ -21,6 +21,8 @@
 #include "QDockWidget"
 #include "QPropNodeItemModel.h"
 #include <QFileSystemWatcher>
+#include <deque>
+#include <future>
 #include <QProcess>
 
 #include "ui_SconeStudio.h"
@@ -50,6 +52,13 @@
 #include "ViewOptions.h"
 #include "UserInputEditor.h"
 #include "MuscleAnalysis.h"
+#include "ResultsCatalog.h"
+#include "ProcessPool.h"
+#include "BatchEvaluation.h"
+#include "VideoEncoder.h"
+#include "OffscreenRenderer.h"
+#include "RealTimeEvaluator.h"
+#include "AsyncLogSink.h"
 
 using scone::TimeInSeconds;
 enum class EvaluationMode { offline, real_time };
@@ -69,6 +78,7 @@ public:
 public slots:
 	void windowShown();
 	void activateBrowserItem( QModelIndex idx );
+	void activateResult( QFileInfo fi );
 	void selectBrowserItem( const QModelIndex& idx, const QModelIndex& idxold );
 	void resultsSelectionChanged( const QItemSelection& newitem, const QItemSelection& olditem ) {}
 	void start();
@@ -94,10 +104,11 @@ public slots:
 	bool abortOptimizations();
 	void updateBackgroundTimer();
 	void handleAutoReload();
-	void checkActiveProcesses();
+	void updateProcessStatus();
 	void updateOptimizations();
 	void createVideo();
 	void captureImage();
+	void exportProfilerTrace();
 	void modelAnalysis();
 	void updateGaitAnalysis();
 	void tabCloseRequested( int idx );
@@ -125,6 +136,8 @@ public slots:
 	void deleteSelectedFileOrFolder();
 	void copyToScenarioFolder();
 	void evaluateSelectedFiles();
+	void evaluateSelectedFilesInBackground();
+	void finalizeBackgroundEvaluation();
 	void sortResultsByDate();
 	void sortResultsByName();
 	void editNotes();
@@ -148,10 +161,17 @@ private:
 	void performanceTest( bool write_stats );
 	void saveUserInputs( bool show_dialog );
 
+	void createOnFirstShow( QDockWidget* dock, void ( SconeStudio::* create )() );
+	void createGaitAnalysis();
+	void createMuscleAnalysis();
+	void createOptimizationHistory();
+	void createResultsCatalog();
+
 	void evaluate();
 	void evaluateOffline();
-	void evaluateRealTime();
 	void startRealTimeEvaluation();
+	void finishRealTimeEvaluation();
+	void updateRealTimeHud();
 	void setTime( TimeInSeconds t );
 	void updateVisualization();
 
@@ -160,6 +180,8 @@ private:
 	bool requestSaveChanges( QCodeEditor* s );
 	int getTabIndex( QCodeEditor* s );
 	void addProgressDock( ProgressDockWidget* pdw );
+	void startQueuedOptimizations();
+	void updateOptimizationRacing();
 
 	// ui
 	Ui::SconeStudioClass ui;
@@ -178,13 +200,31 @@ private:
 	TimeInSeconds evaluation_time_step;
 	TimeInSeconds max_real_time_evaluation_step_;
 	bool real_time_evaluation_enabled_;
+	std::unique_ptr< scone::RealTimeEvaluator > realTimeEvaluator;
+	QLabel* realTimeHud = nullptr;
+	xo::timer realTimeFrameTimer;
+	double realTimeFrameTime = 0.0;
+	double realTimeFrameInterval = 1.0;
+	int realTimeDroppedFrames = 0;
+
+	// interaction latency, from mouse event to rendered response
+	double interactionLatencySum = 0.0;
+	double interactionLatencyMax = 0.0;
+	int interactionLatencyCount = 0;
+	void pushInteraction( const scone::InteractionInput& input );
 
 	// scenario
 	std::vector< ProgressDockWidget* > optimizations;
+	std::deque< std::pair< QString, QStringList > > queuedOptimizations;
 	ResultsFileSystemModel* resultsModel;
 	std::vector< QCodeEditor* > codeEditors;
 	QFileSystemWatcher fileWatcher;
 	QStringList reloadFiles;
+	std::future< bool > tutorialsCheck;
+
+	// messages from all threads are appended to outputText once per frame
+	std::unique_ptr< scone::AsyncLogSink > outputSink;
+	QTimer outputUpdateTimer;
 
 	// viewer
 	xo::flat_map< scone::ViewOption, QAction* > viewActions;
@@ -198,8 +238,10 @@ private:
 
 	// video capture
 	QString captureFilename;
-	QProcess* captureProcess = nullptr;
-	QDir captureImageDir;
+	std::unique_ptr< scone::VideoEncoder > videoEncoder;
+	int captureFrameCount = 0;
+	void renderVideoOffscreen( double frame_step );
+	void updateCaptureProgress();
 	void finalizeCapture();
 
 	// analysis
@@ -247,8 +289,13 @@ private:
 	QDataAnalysisView* optimizationHistoryView = nullptr;
 	QDockWidget* optimizationHistoryDock = nullptr;
 
+	// Results Catalog
+	scone::ResultsCatalog* resultsCatalog = nullptr;
+	QDockWidget* resultsCatalogDock = nullptr;
+
 	// Background processing
-	std::vector<std::unique_ptr<QProcess>> activeProcesses, queuedProcesses;
+	scone::ProcessPool processPool;
+	std::unique_ptr<scone::BatchEvaluation> batchEvaluation;
 };
 
 #endif // SCONESTUDIO_H
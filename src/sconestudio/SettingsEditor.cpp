@@ -122,6 +122,7 @@ namespace scone
 #endif
 			scone_settings.save();
 			studio_settings.save();
+			UpdateStudioSettingsSnapshot();
 		}
 		else
 		{
@@ -28,6 +28,7 @@
 #include "xo/shape/shape_tools.h"
 
 #include "StudioSettings.h"
+#include "TraceRecorder.h"
 
 #include <QMessageBox>
 #include "qt_convert.h"
@@ -86,6 +87,9 @@ namespace scone
 
 			if ( model_ )
 			{
+				for ( auto* b : model_->GetBodies() )
+					body_index_[ b->GetName() ] = b;
+
 				if ( filetype_ == "sto" || filetype_ == "stob" || filename_ == "txt" )
 				{
 					// file is a .sto, load results
@@ -105,9 +109,9 @@ namespace scone
 
 				// set follow body
 				if ( auto s = GetStudioSetting<String>( "viewer.camera_follow_body" ); !s.empty() ) {
-					if ( auto b = TryFindByName( model_->GetBodies(), s ); b != model_->GetBodies().end() )
-						follow_body_ = *b;
-					else log::warning( "Could not find follow body: ", s );
+					follow_body_ = TryFindBody( s );
+					if ( !follow_body_ )
+						log::warning( "Could not find follow body: ", s );
 				}
 
 				// create and init visualizer
@@ -158,6 +162,7 @@ namespace scone
 		if ( model_ && vis_ )
 		{
 			SCONE_PROFILE_FUNCTION( model_->GetProfiler() );
+			STUDIO_TRACE_FUNCTION( "model" );
 			try
 			{
 				if ( !storage_.IsEmpty() && !state_data_index.empty() )
@@ -189,26 +194,30 @@ namespace scone
 		{
 			try
 			{
-				if ( model_objective_ )
-					model_objective_->AdvanceSimulationTo( *model_, t );
-				else
-					model_->AdvanceSimulationTo( t, 1000 );
-				auto te = model_->GetSimulationEndTime();
-				auto t = model_->GetTime();
+				AdvanceSimulationTo( t );
 				if ( model_->HasSimulationEnded() )
 					FinalizeEvaluation();
 			}
 			catch ( std::exception& e )
 			{
-				// simulation exception, abort instead of error so that data remains available
-				AbortEvaluation();
-				log::error( "Error evaluating ", filename_.filename(), ": ", e.what() );
-				QMessageBox::critical( nullptr, "Error evaluating " + to_qt( filename_.filename() ), e.what() );
+				AbortEvaluation( e.what() );
 			}
 		}
 		else log::warning( "Unexpected call to StudioModel::EvaluateTo()" );
 	}
 
+	void StudioModel::AdvanceSimulationTo( TimeInSeconds t )
+	{
+		STUDIO_TRACE_FUNCTION( "simulation" );
+		ApplyInteractions();
+		if ( model_objective_ )
+			model_objective_->AdvanceSimulationTo( *model_, t );
+		else
+			model_->AdvanceSimulationTo( t, 1000 );
+		if ( GetTraceRecorder().enabled() && model_->GetProfiler().enabled() )
+			GetTraceRecorder().recordSnapshot( "ModelProfiler", "model", model_->GetProfiler().report() );
+	}
+
 	void StudioModel::AbortEvaluation()
 	{
 		try
@@ -223,6 +232,65 @@ namespace scone
 		}
 	}
 
+	void StudioModel::AbortEvaluation( const String& error_message )
+	{
+		// simulation exception, abort instead of error so that data remains available
+		AbortEvaluation();
+		log::error( "Error evaluating ", filename_.filename(), ": ", error_message );
+		QMessageBox::critical( nullptr, "Error evaluating " + to_qt( filename_.filename() ), error_message.c_str() );
+	}
+
+	Body* StudioModel::TryFindBody( const String& name ) const
+	{
+		auto it = body_index_.find( name );
+		return it != body_index_.end() ? it->second : nullptr;
+	}
+
+	void StudioModel::PushInteraction( const InteractionInput& input )
+	{
+		std::scoped_lock lock( interaction_mutex_ );
+		if ( input.type == InteractionInput::Type::Move && !interaction_queue_.empty() && interaction_queue_.back().type == InteractionInput::Type::Move )
+			interaction_queue_.back().pos = input.pos; // only the latest position matters, keep the time of the first event
+		else interaction_queue_.push_back( input );
+	}
+
+	void StudioModel::ApplyInteractions()
+	{
+		std::deque<InteractionInput> inputs;
+		{
+			std::scoped_lock lock( interaction_mutex_ );
+			inputs.swap( interaction_queue_ );
+		}
+
+		auto* spr = model_ ? model_->GetInteractionSpring() : nullptr;
+		if ( !spr )
+			return;
+		for ( const auto& input : inputs ) {
+			switch ( input.type )
+			{
+			case InteractionInput::Type::Attach:
+				spr->SetParent( model_->GetGroundBody(), input.pos );
+				spr->SetChild( *input.body, input.local_pos );
+				break;
+			case InteractionInput::Type::Move:
+				spr->SetParent( model_->GetGroundBody(), input.pos );
+				break;
+			case InteractionInput::Type::Release:
+				spr->SetChild( model_->GetGroundBody(), Vec3::zero() );
+				break;
+			}
+			if ( !interaction_time_ )
+				interaction_time_ = input.time;
+		}
+	}
+
+	std::optional<std::chrono::steady_clock::time_point> StudioModel::TakeInteractionTime()
+	{
+		auto t = interaction_time_;
+		interaction_time_.reset();
+		return t;
+	}
+
 	const PropNode& StudioModel::GetResult()
 	{
 		if ( result_pn_.empty() )
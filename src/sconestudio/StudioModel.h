@@ -21,9 +21,24 @@
 #include "qt_convert.h"
 
 #include <future>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 namespace scone
 {
+	/// Mouse interaction with the InteractionSpring, applied before the next simulation step
+	struct InteractionInput {
+		enum class Type { Attach, Move, Release };
+		Type type;
+		Body* body = nullptr; // attached body, only used by Attach
+		Vec3 pos = Vec3::zero(); // world position of the mouse
+		Vec3 local_pos = Vec3::zero(); // attach position in body coordinates, as shown when the mouse was pressed, only used by Attach
+		std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+	};
+
 	class StudioModel
 	{
 	public:
@@ -33,7 +48,21 @@ namespace scone
 		void UpdateVis( TimeInSeconds t );
 		void EvaluateTo( TimeInSeconds t );
 
+		/// advance the simulation without finalizing or reporting errors, can be called from a worker thread
+		void AdvanceSimulationTo( TimeInSeconds t );
+
 		void AbortEvaluation();
+		void AbortEvaluation( const String& error_message );
+
+		/// find body by name without linear search, for picking
+		Body* TryFindBody( const String& name ) const;
+
+		/// queue mouse interaction, can be called while another thread advances the simulation
+		void PushInteraction( const InteractionInput& input );
+		/// apply queued interactions, this is done automatically by AdvanceSimulationTo
+		void ApplyInteractions();
+		/// time of the oldest interaction applied since the previous call, used to measure latency
+		std::optional<std::chrono::steady_clock::time_point> TakeInteractionTime();
 
 		const Storage<>& GetData() { return storage_; }
 		bool HasModel() const { return bool( model_ ) && IsValid(); }
@@ -90,6 +119,10 @@ namespace scone
 		Objective null_objective_;
 		ModelUP model_;
 		Body* follow_body_;
+		std::unordered_map<String, Body*> body_index_;
+		std::deque<InteractionInput> interaction_queue_;
+		std::mutex interaction_mutex_;
+		std::optional<std::chrono::steady_clock::time_point> interaction_time_;
 		path filename_;
 		String filetype_;
 		path scenario_filename_;
@@ -17,6 +17,10 @@
 #include "studio_config.h"
 #include "studio_tools.h"
 #include "studio_settings_schema.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace scone
 {
@@ -46,4 +50,87 @@ namespace scone
 		static StudioSettings settings;
 		return settings;
 	}
+
+	StudioSettingsSnapshot::StudioSettingsSnapshot( const xo::settings& s )
+	{
+		viewer.tile_size = s.get<float>( "viewer.tile_size" );
+		viewer.tile_count_x = s.get<int>( "viewer.tile_count_x" );
+		viewer.tile_count_z = s.get<int>( "viewer.tile_count_z" );
+		viewer.tile1 = s.get<xo::color>( "viewer.tile1" );
+		viewer.tile2 = s.get<xo::color>( "viewer.tile2" );
+		viewer.tiles_follow_body = s.get<bool>( "viewer.tiles_follow_body" );
+		viewer.max_shadow_dist = s.get<float>( "viewer.max_shadow_dist" );
+		viewer.bone = s.get<xo::color>( "viewer.bone" );
+		viewer.tendon = s.get<xo::color>( "viewer.tendon" );
+		viewer.ligament = s.get<xo::color>( "viewer.ligament" );
+		viewer.ligament_100 = s.get<xo::color>( "viewer.ligament_100" );
+		viewer.spring = s.get<xo::color>( "viewer.spring" );
+		viewer.force = s.get<xo::color>( "viewer.force" );
+		viewer.joint_force = s.get<xo::color>( "viewer.joint_force" );
+		viewer.force_alpha = s.get<float>( "viewer.force_alpha" );
+		viewer.forces_cast_shadows = s.get<bool>( "viewer.forces_cast_shadows" );
+		viewer.combine_contact_forces = s.get<int>( "viewer.combine_contact_forces" );
+		viewer.joint_forces_are_for_parents = s.get<bool>( "viewer.joint_forces_are_for_parents" );
+		viewer.joint_arrow_length = s.get<float>( "viewer.joint_arrow_length" );
+		viewer.force_arrow_length = s.get<float>( "viewer.force_arrow_length" );
+		viewer.arrow_shape = s.get<float>( "viewer.arrow_shape" );
+		viewer.moment = s.get<xo::color>( "viewer.moment" );
+		viewer.contact = s.get<xo::color>( "viewer.contact" );
+		viewer.contact_alpha = s.get<float>( "viewer.contact_alpha" );
+		viewer.contact_geometries_cast_shadows = s.get<bool>( "viewer.contact_geometries_cast_shadows" );
+		viewer.auxiliary = s.get<xo::color>( "viewer.auxiliary" );
+		viewer.auxiliary_alpha = s.get<float>( "viewer.auxiliary_alpha" );
+		viewer.static_geom = s.get<xo::color>( "viewer.static" );
+		viewer.object = s.get<xo::color>( "viewer.object" );
+		viewer.joint = s.get<xo::color>( "viewer.joint" );
+		viewer.com = s.get<xo::color>( "viewer.com" );
+		viewer.muscle_min100 = s.get<xo::color>( "viewer.muscle_min100" );
+		viewer.muscle_0 = s.get<xo::color>( "viewer.muscle_0" );
+		viewer.muscle_50 = s.get<xo::color>( "viewer.muscle_50" );
+		viewer.muscle_100 = s.get<xo::color>( "viewer.muscle_100" );
+		viewer.specular = s.get<float>( "viewer.specular" );
+		viewer.shininess = s.get<float>( "viewer.shininess" );
+		viewer.ambient = s.get<float>( "viewer.ambient" );
+		viewer.auto_muscle_width = s.get<bool>( "viewer.auto_muscle_width" );
+		viewer.auto_muscle_width_factor = s.get<float>( "viewer.auto_muscle_width_factor" );
+		viewer.muscle_width = s.get<float>( "viewer.muscle_width" );
+		viewer.muscle_position = s.get<float>( "viewer.muscle_position" );
+		viewer.relative_tendon_width = s.get<float>( "viewer.relative_tendon_width" );
+		viewer.spring_width = s.get<float>( "viewer.spring_width" );
+		viewer.joint_radius = s.get<float>( "viewer.joint_radius" );
+		viewer.body_axes_length = s.get<float>( "viewer.body_axes_length" );
+		viewer.camera_orbit_speed = s.get<float>( "viewer.camera_orbit_speed" );
+
+		gait_analysis.plot_individual_cycles = s.get<bool>( "gait_analysis.plot_individual_cycles" );
+		gait_analysis.show_swing_start = s.get<int>( "gait_analysis.show_swing_start" );
+		gait_analysis.show_fit = s.get<bool>( "gait_analysis.show_fit" );
+		gait_analysis.plot_step_frame_lead = s.get<Real>( "gait_analysis.plot_step_frame_lead" );
+
+		progress.line_width = s.get<float>( "progress.line_width" );
+		progress.full_resolution_generations = s.get<int>( "progress.full_resolution_generations" );
+
+		sconegym.max_concurrent_evaluations = s.get<size_t>( "sconegym.max_concurrent_evaluations" );
+		sconegym.memory_per_evaluation = s.get<int>( "sconegym.memory_per_evaluation" );
+	}
+
+	// previous snapshots are kept, because other threads may still be reading them
+	static std::atomic<const StudioSettingsSnapshot*> g_SettingsSnapshot( nullptr );
+	static std::vector< std::unique_ptr< const StudioSettingsSnapshot > > g_SettingsSnapshots;
+	static std::mutex g_SettingsSnapshotMutex;
+
+	const StudioSettingsSnapshot& GetStudioSettingsSnapshot()
+	{
+		if ( auto* s = g_SettingsSnapshot.load( std::memory_order_acquire ) )
+			return *s;
+		UpdateStudioSettingsSnapshot();
+		return *g_SettingsSnapshot.load( std::memory_order_acquire );
+	}
+
+	void UpdateStudioSettingsSnapshot()
+	{
+		std::scoped_lock lock( g_SettingsSnapshotMutex );
+		auto s = std::make_unique< const StudioSettingsSnapshot >( GetStudioSettings() );
+		g_SettingsSnapshot.store( s.get(), std::memory_order_release );
+		g_SettingsSnapshots.push_back( std::move( s ) );
+	}
 }
@@ -12,6 +12,7 @@
 #include "xo/system/settings.h"
 #include "scone/core/types.h"
 #include "scone/core/Exception.h"
+#include "xo/utility/color.h"
 
 namespace scone
 {
@@ -26,4 +27,84 @@ namespace scone
 		try { return GetStudioSettings().get< T >( key ); }
 		catch ( const std::exception& e ) { SCONE_ERROR( "Could not read setting \"" + key + "\" (" + e.what() + ")" ); }
 	}
+
+	/// Typed copy of the studio settings that are read in frequently called code.
+	/// Members follow the sections and keys of studio_settings_schema.h.
+	struct StudioSettingsSnapshot
+	{
+		explicit StudioSettingsSnapshot( const xo::settings& s );
+
+		struct {
+			float tile_size;
+			int tile_count_x;
+			int tile_count_z;
+			xo::color tile1;
+			xo::color tile2;
+			bool tiles_follow_body;
+			float max_shadow_dist;
+			xo::color bone;
+			xo::color tendon;
+			xo::color ligament;
+			xo::color ligament_100;
+			xo::color spring;
+			xo::color force;
+			xo::color joint_force;
+			float force_alpha;
+			bool forces_cast_shadows;
+			int combine_contact_forces;
+			bool joint_forces_are_for_parents;
+			float joint_arrow_length;
+			float force_arrow_length;
+			float arrow_shape;
+			xo::color moment;
+			xo::color contact;
+			float contact_alpha;
+			bool contact_geometries_cast_shadows;
+			xo::color auxiliary;
+			float auxiliary_alpha;
+			xo::color static_geom; // viewer.static
+			xo::color object;
+			xo::color joint;
+			xo::color com;
+			xo::color muscle_min100;
+			xo::color muscle_0;
+			xo::color muscle_50;
+			xo::color muscle_100;
+			float specular;
+			float shininess;
+			float ambient;
+			bool auto_muscle_width;
+			float auto_muscle_width_factor;
+			float muscle_width;
+			float muscle_position;
+			float relative_tendon_width;
+			float spring_width;
+			float joint_radius;
+			float body_axes_length;
+			float camera_orbit_speed;
+		} viewer;
+
+		struct {
+			bool plot_individual_cycles;
+			int show_swing_start;
+			bool show_fit;
+			Real plot_step_frame_lead;
+		} gait_analysis;
+
+		struct {
+			float line_width;
+			int full_resolution_generations;
+		} progress;
+
+		struct {
+			size_t max_concurrent_evaluations;
+			int memory_per_evaluation;
+		} sconegym;
+	};
+
+	/// Current settings snapshot, cheap and thread-safe; references remain valid after an update
+	const StudioSettingsSnapshot& GetStudioSettingsSnapshot();
+
+	/// Rebuild the snapshot after the studio settings have changed
+	void UpdateStudioSettingsSnapshot();
 }
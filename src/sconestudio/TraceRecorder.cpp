@@ -0,0 +1,177 @@
+/*
+** TraceRecorder.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+
+namespace scone
+{
+	// number of events kept by the shared recorder, about 40 bytes each
+	constexpr size_t trace_recorder_capacity = 1 << 17;
+
+	// number of snapshots kept by a recorder, a model profiler report is a few kB
+	constexpr size_t trace_snapshot_capacity = 1024;
+
+	static std::int64_t GetTraceTime( std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now() )
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>( t.time_since_epoch() ).count();
+	}
+
+	static std::uint32_t GetTraceThreadId()
+	{
+		// small sequential ids are easier to read in trace viewers than native thread ids
+		static std::atomic<std::uint32_t> next_id( 1 );
+		thread_local std::uint32_t id = next_id++;
+		return id;
+	}
+
+	static void WriteJsonString( std::ostream& str, const char* s )
+	{
+		str << '"';
+		for ( ; *s; ++s ) {
+			if ( *s == '"' || *s == '\\' )
+				str << '\\';
+			str << *s;
+		}
+		str << '"';
+	}
+
+	static void WriteJsonArgs( std::ostream& str, const PropNode& pn )
+	{
+		// same layout as the benchmark json, nodes with children are objects with an optional value
+		if ( pn.size() == 0 )
+			return WriteJsonString( str, pn.raw_value().c_str() );
+		str << '{';
+		bool first = true;
+		if ( !pn.raw_value().empty() ) {
+			str << "\"value\":";
+			WriteJsonString( str, pn.raw_value().c_str() );
+			first = false;
+		}
+		for ( const auto& [key, child] : pn ) {
+			str << ( first ? "" : "," );
+			WriteJsonString( str, key.c_str() );
+			str << ':';
+			WriteJsonArgs( str, child );
+			first = false;
+		}
+		str << '}';
+	}
+
+	TraceRecorder::TraceRecorder( size_t capacity ) :
+		capacity_( capacity ),
+		slots_( std::make_unique<Slot[]>( capacity ) ),
+		next_( 0 ),
+		enabled_( false ),
+		start_time_( GetTraceTime() )
+	{}
+
+	std::int64_t TraceRecorder::now() const
+	{
+		return GetTraceTime() - start_time_;
+	}
+
+	std::int64_t TraceRecorder::toTraceTime( std::chrono::steady_clock::time_point t ) const
+	{
+		return GetTraceTime( t ) - start_time_;
+	}
+
+	void TraceRecorder::record( const char* name, const char* category, std::int64_t start_time )
+	{
+		auto end_time = now();
+		auto idx = next_.fetch_add( 1, std::memory_order_relaxed );
+		auto& slot = slots_[ idx % capacity_ ];
+		slot.sequence.store( 0, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+		slot.event = Event{ name, category, GetTraceThreadId(), start_time, end_time - start_time };
+		slot.sequence.store( idx + 1, std::memory_order_release );
+	}
+
+	void TraceRecorder::recordSnapshot( const char* name, const char* category, PropNode args )
+	{
+		auto time = now();
+		std::scoped_lock lock( snapshot_mutex_ );
+		if ( snapshots_.size() >= trace_snapshot_capacity )
+			snapshots_.pop_front();
+		snapshots_.push_back( Snapshot{ name, category, GetTraceThreadId(), time, std::move( args ) } );
+	}
+
+	void TraceRecorder::clear()
+	{
+		for ( size_t i = 0; i < capacity_; ++i )
+			slots_[ i ].sequence.store( 0, std::memory_order_relaxed );
+		next_ = 0;
+		std::scoped_lock lock( snapshot_mutex_ );
+		snapshots_.clear();
+	}
+
+	size_t TraceRecorder::eventCount() const
+	{
+		std::scoped_lock lock( snapshot_mutex_ );
+		return std::min<size_t>( next_.load(), capacity_ ) + snapshots_.size();
+	}
+
+	void TraceRecorder::writeChromeTrace( std::ostream& str ) const
+	{
+		auto end = next_.load( std::memory_order_acquire );
+		auto begin = end > capacity_ ? end - capacity_ : 0;
+		bool first = true;
+		str << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for ( auto idx = begin; idx < end; ++idx )
+		{
+			// skip events that are being written or have been overwritten since
+			const auto& slot = slots_[ idx % capacity_ ];
+			if ( slot.sequence.load( std::memory_order_acquire ) != idx + 1 )
+				continue;
+			auto e = slot.event;
+			std::atomic_thread_fence( std::memory_order_acquire );
+			if ( slot.sequence.load( std::memory_order_relaxed ) != idx + 1 )
+				continue;
+
+			str << ( first ? "\n" : ",\n" ) << "{\"name\":";
+			WriteJsonString( str, e.name );
+			str << ",\"cat\":";
+			WriteJsonString( str, e.category );
+			str << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread << ",\"ts\":" << e.time << ",\"dur\":" << e.duration << '}';
+			first = false;
+		}
+
+		std::scoped_lock lock( snapshot_mutex_ );
+		for ( const auto& s : snapshots_ )
+		{
+			str << ( first ? "\n" : ",\n" ) << "{\"name\":";
+			WriteJsonString( str, s.name );
+			str << ",\"cat\":";
+			WriteJsonString( str, s.category );
+			str << ",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << s.thread << ",\"ts\":" << s.time << ",\"args\":";
+			WriteJsonArgs( str, s.args );
+			str << '}';
+			first = false;
+		}
+		str << "\n]}\n";
+	}
+
+	bool TraceRecorder::writeChromeTrace( const xo::path& file ) const
+	{
+		std::ofstream str( file.str() );
+		if ( !str.good() )
+			return false;
+		writeChromeTrace( str );
+		return str.good();
+	}
+
+	TraceRecorder& GetTraceRecorder()
+	{
+		static TraceRecorder recorder( trace_recorder_capacity );
+		return recorder;
+	}
+}
@@ -0,0 +1,108 @@
+/*
+** TraceRecorder.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <iosfwd>
+#include <mutex>
+#include <deque>
+#include "scone/core/types.h"
+#include "scone/core/PropNode.h"
+#include "xo/filesystem/path.h"
+
+namespace scone
+{
+	/// Records timestamped scopes from all threads into a ring buffer, one complete event per scope.
+	/// When the buffer is full, the oldest events are overwritten. Recording does not lock.
+	/// Snapshots are instant events with a PropNode as arguments, intended for low-rate data such as profiler totals;
+	/// these are stored separately under a lock, the oldest are dropped when there are more than the snapshot capacity.
+	/// Events can be exported in the Chrome trace format, for viewing in chrome://tracing or Perfetto.
+	class TraceRecorder
+	{
+	public:
+		/// event names and categories must be string literals, only the pointer is stored
+		struct Event {
+			const char* name;
+			const char* category;
+			std::uint32_t thread;
+			std::int64_t time; // start time in microseconds since the recorder was created
+			std::int64_t duration; // in microseconds
+		};
+
+		explicit TraceRecorder( size_t capacity );
+
+		void setEnabled( bool enabled ) { enabled_.store( enabled, std::memory_order_relaxed ); }
+		bool enabled() const { return enabled_.load( std::memory_order_relaxed ); }
+
+		/// current time in microseconds since the recorder was created
+		std::int64_t now() const;
+		/// time in microseconds since the recorder was created, for events that started before they are recorded
+		std::int64_t toTraceTime( std::chrono::steady_clock::time_point t ) const;
+		void record( const char* name, const char* category, std::int64_t start_time );
+		void recordSnapshot( const char* name, const char* category, PropNode args );
+		void clear();
+		size_t eventCount() const;
+
+		/// write recorded events as Chrome trace JSON, events that are overwritten while writing are skipped
+		void writeChromeTrace( std::ostream& str ) const;
+		bool writeChromeTrace( const xo::path& file ) const;
+
+	private:
+		struct Slot {
+			Event event;
+			std::atomic<std::uint64_t> sequence; // index + 1 of the event in this slot, 0 while writing
+		};
+		struct Snapshot {
+			const char* name;
+			const char* category;
+			std::uint32_t thread;
+			std::int64_t time;
+			PropNode args;
+		};
+
+		size_t capacity_;
+		std::unique_ptr<Slot[]> slots_;
+		std::atomic<std::uint64_t> next_;
+		std::atomic<bool> enabled_;
+		std::int64_t start_time_;
+
+		mutable std::mutex snapshot_mutex_;
+		std::deque<Snapshot> snapshots_;
+	};
+
+	/// Recorder shared by the GUI profiler scopes and the studio model scopes, enabled with ui.enable_profiler.
+	/// The model profiler (SCONE_PROFILE_FUNCTION) has no timestamped sections, when it is enabled its report with
+	/// the accumulated section totals is recorded as a ModelProfiler snapshot after each simulation step.
+	TraceRecorder& GetTraceRecorder();
+
+	/// Records the scope as a single event on destruction, if the recorder was enabled on construction
+	class ScopedTrace
+	{
+	public:
+		ScopedTrace( const char* category, const char* name ) :
+			category_( category ), name_( name ), start_time_( GetTraceRecorder().enabled() ? GetTraceRecorder().now() : -1 )
+		{}
+		~ScopedTrace() {
+			if ( start_time_ >= 0 ) GetTraceRecorder().record( name_, category_, start_time_ );
+		}
+
+	private:
+		const char* category_;
+		const char* name_;
+		std::int64_t start_time_;
+	};
+}
+
+#define STUDIO_TRACE_CONCATENATE_IMPL( a, b ) a##b
+#define STUDIO_TRACE_CONCATENATE( a, b ) STUDIO_TRACE_CONCATENATE_IMPL( a, b )
+#define STUDIO_TRACE_SCOPE( category, name ) ::scone::ScopedTrace STUDIO_TRACE_CONCATENATE( scoped_trace_, __LINE__ )( category, name )
+#define STUDIO_TRACE_FUNCTION( category ) STUDIO_TRACE_SCOPE( category, __FUNCTION__ )
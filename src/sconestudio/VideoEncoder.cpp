@@ -0,0 +1,203 @@
+/*
+** VideoEncoder.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "VideoEncoder.h"
+
+#include <QProcess>
+#include <QStringList>
+#include <osg/GL>
+#include <osg/GraphicsContext>
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+
+namespace scone
+{
+	VideoEncoder::VideoEncoder( const VideoEncoderSettings& s ) :
+		settings_( s ),
+		buffers_( s.buffer_count, QByteArray( s.width * s.height * 3, 0 ) ),
+		acquired_buffer_( -1 ),
+		closing_( false ),
+		started_( false ),
+		finished_( false ),
+		frames_submitted_( 0 ),
+		frames_encoded_( 0 )
+	{
+		for ( int i = 0; i < s.buffer_count; ++i )
+			free_buffers_.push_back( i );
+		thread_ = std::thread( &VideoEncoder::threadFunc, this );
+	}
+
+	VideoEncoder::~VideoEncoder()
+	{
+		finish();
+		if ( thread_.joinable() )
+			thread_.join();
+	}
+
+	bool VideoEncoder::waitForStarted()
+	{
+		std::unique_lock lock( mutex_ );
+		cv_.wait( lock, [&]() { return started_ || finished_; } );
+		return started_;
+	}
+
+	uchar* VideoEncoder::acquireFrame()
+	{
+		// this is where back-pressure is applied: wait until ffmpeg has consumed a buffer
+		std::unique_lock lock( mutex_ );
+		SCONE_ASSERT( acquired_buffer_ < 0 );
+		cv_.wait( lock, [&]() { return !free_buffers_.empty() || finished_; } );
+		if ( finished_ || closing_ )
+			return nullptr;
+		acquired_buffer_ = free_buffers_.front();
+		free_buffers_.pop_front();
+		return reinterpret_cast<uchar*>( buffers_[ acquired_buffer_ ].data() );
+	}
+
+	void VideoEncoder::submitFrame()
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			SCONE_ASSERT( acquired_buffer_ >= 0 );
+			filled_buffers_.push_back( acquired_buffer_ );
+			acquired_buffer_ = -1;
+			++frames_submitted_;
+		}
+		cv_.notify_all();
+	}
+
+	void VideoEncoder::finish()
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			closing_ = true;
+		}
+		cv_.notify_all();
+	}
+
+	bool VideoEncoder::waitForFinished( int msecs )
+	{
+		std::unique_lock lock( mutex_ );
+		return cv_.wait_for( lock, std::chrono::milliseconds( msecs ), [&]() { return bool( finished_ ); } );
+	}
+
+	QString VideoEncoder::errorString() const
+	{
+		std::scoped_lock lock( mutex_ );
+		return error_;
+	}
+
+	void VideoEncoder::readOutput( QProcess& process )
+	{
+		// ffmpeg writes key=value lines to stdout, frame=<n> is the number of encoded frames
+		progress_output_ += process.readAllStandardOutput();
+		for ( int eol = progress_output_.indexOf( '\n' ); eol >= 0; eol = progress_output_.indexOf( '\n' ) ) {
+			auto line = progress_output_.left( eol ).trimmed();
+			progress_output_.remove( 0, eol + 1 );
+			if ( line.startsWith( "frame=" ) )
+				frames_encoded_ = line.mid( 6 ).toInt();
+		}
+
+		// keep only the last part of the error output
+		error_output_ += process.readAllStandardError();
+		if ( error_output_.size() > 4096 )
+			error_output_ = error_output_.right( 4096 );
+	}
+
+	void VideoEncoder::threadFunc()
+	{
+		const auto& s = settings_;
+		QStringList args;
+		args << "-y" << "-loglevel" << "error" << "-nostats" << "-progress" << "pipe:1"
+			<< "-f" << "rawvideo" << "-pix_fmt" << "rgb24"
+			<< "-s" << QString( "%1x%2" ).arg( s.width ).arg( s.height )
+			<< "-r" << QString::number( s.frame_rate )
+			<< "-i" << "-"
+			<< "-vf" << QString( s.flip_vertical ? "vflip," : "" ) + "crop=trunc(iw/2)*2:trunc(ih/2)*2" // mpeg4 requires even dimensions
+			<< "-c:v" << "mpeg4"
+			<< "-q:v" << QString::number( s.quality )
+			<< s.filename;
+
+		// QProcess is created in this thread and used with blocking calls only
+		QProcess process;
+		process.start( s.ffmpeg, args );
+		if ( !process.waitForStarted( 5000 ) ) {
+			{
+				std::scoped_lock lock( mutex_ );
+				error_ = "Could not start " + s.ffmpeg + ": " + process.errorString();
+				finished_ = true;
+			}
+			cv_.notify_all();
+			return;
+		}
+		{
+			std::scoped_lock lock( mutex_ );
+			started_ = true;
+		}
+		cv_.notify_all();
+		log::debug( "Started ffmpeg for ", s.filename.toStdString(), " (", s.width, "x", s.height, ")" );
+
+		while ( true )
+		{
+			int idx;
+			{
+				std::unique_lock lock( mutex_ );
+				cv_.wait( lock, [&]() { return !filled_buffers_.empty() || closing_; } );
+				if ( filled_buffers_.empty() )
+					break;
+				idx = filled_buffers_.front();
+				filled_buffers_.pop_front();
+			}
+
+			process.write( buffers_[ idx ] );
+			while ( process.bytesToWrite() > 0 && process.state() == QProcess::Running )
+				process.waitForBytesWritten( 100 );
+			readOutput( process );
+
+			{
+				std::scoped_lock lock( mutex_ );
+				free_buffers_.push_back( idx );
+			}
+			cv_.notify_all();
+
+			if ( process.state() != QProcess::Running )
+				break; // ffmpeg has stopped, remaining frames are discarded
+		}
+
+		// encoding continues after stdin is closed, wait without timeout
+		process.closeWriteChannel();
+		while ( process.state() != QProcess::NotRunning && !process.waitForFinished( 100 ) )
+			readOutput( process );
+		readOutput( process );
+
+		{
+			std::scoped_lock lock( mutex_ );
+			if ( process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0 )
+				error_ = QString( "ffmpeg exited with code %1: %2" ).arg( process.exitCode() ).arg( QString::fromLocal8Bit( error_output_ ) );
+			finished_ = true;
+		}
+		cv_.notify_all();
+	}
+
+	void VideoCaptureCallback::operator()( osg::RenderInfo& renderInfo ) const
+	{
+		const auto& s = encoder_.settings();
+		const auto* vp = renderInfo.getCurrentCamera()->getViewport();
+		if ( !vp || int( vp->width() ) != s.width || int( vp->height() ) != s.height )
+			return log::warning( "Viewer size has changed, frame is skipped" );
+
+		if ( auto* data = encoder_.acquireFrame() ) {
+			auto* gc = renderInfo.getState()->getGraphicsContext();
+			bool double_buffer = gc && gc->getTraits() && gc->getTraits()->doubleBuffer;
+			glReadBuffer( double_buffer ? GL_BACK : GL_FRONT );
+			glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+			glReadPixels( GLint( vp->x() ), GLint( vp->y() ), s.width, s.height, GL_RGB, GL_UNSIGNED_BYTE, data );
+			encoder_.submitFrame();
+		}
+	}
+}
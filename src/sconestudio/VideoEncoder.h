@@ -0,0 +1,93 @@
+/*
+** VideoEncoder.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <osg/Camera>
+
+namespace scone
+{
+	struct VideoEncoderSettings {
+		QString ffmpeg;
+		QString filename;
+		int width = 0;
+		int height = 0;
+		double frame_rate = 30.0;
+		int quality = 2;
+		int buffer_count = 8; // number of frames that can be queued before acquireFrame() blocks
+		bool flip_vertical = true; // OpenGL frames are stored bottom-up
+	};
+
+	/// Encodes a video by streaming raw RGB frames to the stdin of ffmpeg, without intermediate files.
+	/// Frames are written by a background thread, using a fixed ring of reusable frame buffers.
+	/// When all buffers are in use, acquireFrame() blocks until ffmpeg has consumed a frame.
+	class VideoEncoder
+	{
+	public:
+		VideoEncoder( const VideoEncoderSettings& s );
+		~VideoEncoder();
+
+		/// returns false if ffmpeg could not be started, see errorString()
+		bool waitForStarted();
+
+		/// buffer of width * height * 3 bytes for the next frame, or nullptr if encoding has stopped
+		uchar* acquireFrame();
+		/// queue the frame returned by acquireFrame() for encoding
+		void submitFrame();
+
+		/// close the input of ffmpeg, queued frames are still encoded
+		void finish();
+		bool waitForFinished( int msecs );
+		bool isFinished() const { return finished_; }
+
+		const VideoEncoderSettings& settings() const { return settings_; }
+		int framesSubmitted() const { return frames_submitted_; }
+		int framesEncoded() const { return frames_encoded_; }
+		QString errorString() const;
+
+	private:
+		void threadFunc();
+		void readOutput( class QProcess& process );
+
+		VideoEncoderSettings settings_;
+		std::vector<QByteArray> buffers_;
+		std::deque<int> free_buffers_;
+		std::deque<int> filled_buffers_;
+		int acquired_buffer_;
+		bool closing_;
+		std::atomic<bool> started_;
+		std::atomic<bool> finished_;
+		std::atomic<int> frames_submitted_;
+		std::atomic<int> frames_encoded_;
+		QByteArray progress_output_;
+		QByteArray error_output_;
+		QString error_;
+		mutable std::mutex mutex_;
+		std::condition_variable cv_;
+		std::thread thread_;
+	};
+
+	/// Camera draw callback that reads back each rendered frame into a VideoEncoder
+	class VideoCaptureCallback : public osg::Camera::DrawCallback
+	{
+	public:
+		VideoCaptureCallback( VideoEncoder& encoder ) : encoder_( encoder ) {}
+		virtual void operator()( osg::RenderInfo& renderInfo ) const override;
+
+	private:
+		VideoEncoder& encoder_;
+	};
+}
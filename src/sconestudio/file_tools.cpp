@@ -6,7 +6,15 @@
 #include <QFile>
 #include <QCryptographicHash>
 #include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QHash>
 #include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <optional>
 #include "scone/core/system_tools.h"
 #include "scone/core/Log.h"
 #include "xo/filesystem/filesystem.h"
@@ -18,6 +26,7 @@
 #include "scone/core/PropNode.h"
 #include "xo/serialization/prop_node_serializer_zml.h"
 #include "scone/core/Factories.h"
+#include "ResultsIndex.h"
 
 namespace fs = std::filesystem;
 
@@ -34,55 +43,177 @@ namespace scone
 	}
 
 	QFileInfo findBestPar( const QDir& dir )
+	{
+		return findBestPar( dir, GetResultsIndex() );
+	}
+
+	QFileInfo findBestPar( const QDir& dir, ResultsIndex& index )
 	{
 		const int min_file_age_sec = 3; // #todo: setting?
+
+		// use the summary from the results index, which is updated when the folder is modified
+		// when the folder is scanned, its .par files are kept for finding an older file below
+		QFileInfo dirInfo( dir.absolutePath() );
+		std::optional<QFileInfoList> parFiles;
+		auto stat = index.find( dirInfo.absoluteFilePath() );
+		if ( !stat || !isResultStatusUpToDate( *stat, dirInfo ) ) {
+			parFiles.emplace();
+			stat = scanResultFolder( dirInfo.absoluteFilePath(), &*parFiles );
+			index.insert( dirInfo.absoluteFilePath(), *stat );
+		}
+		if ( stat->best_file.isEmpty() )
+			return QFileInfo();
+		QFileInfo summaryFile( dir.filePath( stat->best_file ) );
+		if ( summaryFile.isFile() && summaryFile.lastModified().secsTo( QDateTime::currentDateTime() ) >= min_file_age_sec )
+			return summaryFile;
+
+		// the latest file may still be written, find the best file that is old enough
+		if ( !parFiles ) {
+			parFiles.emplace();
+			for ( QDirIterator it( dir.absolutePath(), { "*.par" }, QDir::Files ); it.hasNext(); it.next() )
+				parFiles->push_back( it.fileInfo() );
+		}
 		QFileInfo bestFile;
 		int bestGen = -1;
 		auto now = QDateTime::currentDateTime();
-		for ( QDirIterator it( dir ); it.hasNext(); it.next() )
+		for ( const auto& fi : *parFiles )
 		{
-			auto fi = it.fileInfo();
-			if ( fi.isFile() && fi.suffix() == "par" )
-			{
-				auto [gen, best] = extractGenBestFromParFile( fi );
-				if ( gen > bestGen && fi.lastModified().secsTo( now ) >= min_file_age_sec ) {
-					bestFile = fi;
-					bestGen = gen;
-				}
+			auto [gen, best] = extractGenBestFromParFile( fi );
+			if ( gen > bestGen && fi.lastModified().secsTo( now ) >= min_file_age_sec ) {
+				bestFile = fi;
+				bestGen = gen;
 			}
 		}
 		return bestFile;
 	}
 
-	QByteArray fileHash( QFile& file ) {
+	QByteArray fileHash( const QString& filename )
+	{
+		// hash in fixed-size chunks, so that large data files are never loaded into memory at once
+		constexpr qint64 buffer_size = 64 * 1024;
+		QFile file( filename );
+		if ( !file.open( QIODevice::ReadOnly ) )
+			return QByteArray();
 		QCryptographicHash hash( QCryptographicHash::Md5 );
-		file.open( QIODevice::ReadOnly );
-		hash.addData( file.readAll() );
-		file.close();
+		std::vector<char> buf( buffer_size );
+		for ( qint64 n = file.read( buf.data(), buffer_size ); n > 0; n = file.read( buf.data(), buffer_size ) )
+			hash.addData( buf.data(), int( n ) );
 		return hash.result();
 	}
 
+	/// Persistent hashes of tutorial and example files, valid as long as size and modification time are unchanged
+	class FileHashManifest
+	{
+	public:
+		FileHashManifest( const xo::path& file ) : file_( file ), modified_( false ) { load(); }
+
+		QByteArray hash( const QFileInfo& fi ) {
+			{
+				std::scoped_lock lock( mutex_ );
+				if ( auto it = entries_.find( fi.absoluteFilePath() ); it != entries_.end() )
+					if ( it->size == fi.size() && it->modified == fi.lastModified().toMSecsSinceEpoch() )
+						return it->hash;
+			}
+			auto h = fileHash( fi.absoluteFilePath() );
+			std::scoped_lock lock( mutex_ );
+			entries_[ fi.absoluteFilePath() ] = Entry{ fi.size(), fi.lastModified().toMSecsSinceEpoch(), h };
+			modified_ = true;
+			return h;
+		}
+
+		void saveIfModified() {
+			std::scoped_lock lock( mutex_ );
+			if ( !modified_ )
+				return;
+			QSaveFile file( to_qt( file_ ) );
+			if ( !file.open( QIODevice::WriteOnly ) )
+				return;
+			QDataStream str( &file );
+			str.setVersion( QDataStream::Qt_5_9 );
+			str << manifest_magic << quint32( entries_.size() );
+			for ( auto it = entries_.begin(); it != entries_.end(); ++it )
+				str << it.key() << it->size << it->modified << it->hash;
+			if ( file.commit() )
+				modified_ = false;
+			else log::warning( "Could not write file manifest ", file_ );
+		}
+
+	private:
+		void load() {
+			QFile file( to_qt( file_ ) );
+			if ( !file.open( QIODevice::ReadOnly ) )
+				return;
+			QDataStream str( &file );
+			str.setVersion( QDataStream::Qt_5_9 );
+			quint32 magic = 0, count = 0;
+			str >> magic >> count;
+			if ( magic != manifest_magic )
+				return;
+			for ( quint32 i = 0; i < count && str.status() == QDataStream::Ok; ++i ) {
+				QString filename;
+				Entry e;
+				str >> filename >> e.size >> e.modified >> e.hash;
+				entries_.insert( filename, e );
+			}
+			if ( str.status() != QDataStream::Ok )
+				entries_.clear();
+		}
+
+		static constexpr quint32 manifest_magic = 0x53464d31; // "SFM1"
+		struct Entry { qint64 size; qint64 modified; QByteArray hash; };
+		xo::path file_;
+		QHash<QString, Entry> entries_;
+		bool modified_;
+		std::mutex mutex_;
+	};
+
+	FileHashManifest& GetFileHashManifest()
+	{
+		static FileHashManifest manifest( GetSettingsFolder() / "tutorials_manifest.bin" );
+		return manifest;
+	}
+
 	CompareFoldersResult compareFolders( const QString& sourceDir, const QString& targetDir )
 	{
 		auto result = CompareFoldersResult();
+
+		// collect existing file pairs; files with different sizes need no hashing
+		std::vector<std::pair<QFileInfo, QFileInfo>> pairs;
 		QDirIterator it( sourceDir, QDir::Files, QDirIterator::Subdirectories );
 		while ( it.hasNext() ) {
-			QFile srcFile = it.next();
-			QFile trgFile = srcFile.fileName().replace( sourceDir, targetDir );
+			QFileInfo srcFile = it.next();
+			QFileInfo trgFile = srcFile.filePath().replace( sourceDir, targetDir );
 			result.checked++;
-			if ( trgFile.exists() ) {
-				auto srcHash = fileHash( srcFile );
-				auto trgHash = fileHash( trgFile );
-				if ( srcHash != trgHash ) {
-					log::debug( trgFile.fileName().toStdString(), " is different from the installed version" );
-					result.different.append( trgFile.fileName() );
-				}
-			}
-			else {
+			if ( !trgFile.exists() )
 				result.missing++;
-				//log::debug( trgFile.fileName().toStdString(), " is missing" );
-			}
+			else if ( srcFile.size() != trgFile.size() )
+				result.different.append( trgFile.filePath() );
+			else pairs.emplace_back( srcFile, trgFile );
 		}
+
+		// hash remaining pairs in parallel, using the manifest for files that are unchanged
+		auto& manifest = GetFileHashManifest();
+		std::vector<char> equal( pairs.size(), 0 );
+		std::atomic<size_t> next_pair = 0;
+		auto worker = [&]() {
+			for ( size_t i = next_pair++; i < pairs.size(); i = next_pair++ )
+				equal[ i ] = manifest.hash( pairs[ i ].first ) == manifest.hash( pairs[ i ].second );
+		};
+		auto num_threads = std::min<size_t>( std::max( 1u, std::thread::hardware_concurrency() ), pairs.size() );
+		std::vector<std::thread> threads;
+		for ( size_t i = 1; i < num_threads; ++i )
+			threads.emplace_back( worker );
+		worker();
+		for ( auto& t : threads )
+			t.join();
+		manifest.saveIfModified();
+
+		for ( size_t i = 0; i < pairs.size(); ++i )
+			if ( !equal[ i ] )
+				result.different.append( pairs[ i ].second.filePath() );
+		for ( const auto& f : result.different )
+			log::debug( f.toStdString(), " is different from the installed version" );
+
 		return result;
 	}
 
@@ -101,51 +232,79 @@ namespace scone
 		else return true;
 	}
 
+	struct TutorialsExamplesFolders
+	{
+		TutorialsExamplesFolders() :
+			version( GetStudioSetting<int>( "ui.tutorials_version" ) ),
+			srcPath( scone::GetFolder( scone::SconeFolder::Root ) / "scenarios" ),
+			trgPath( scone::GetFolder( scone::SconeFolder::Scenarios ) ),
+			tutsrc( srcPath / xo::stringf( "Tutorials%d", version ) ),
+			exsrc( srcPath / xo::stringf( "Examples%d", version ) ),
+			tuttrg( trgPath / "Tutorials" ),
+			extrg( trgPath / "Examples" ),
+			pysrc( srcPath / "SconePy" ),
+			pytrg( trgPath / "SconePy" )
+		{
+			// check which version is installed
+			int tutver = 3;
+			if ( fs::exists( to_fs( tuttrg ) / "Tutorial 1 - Introduction.scone" ) )
+				tutver = 1;
+			else if ( fs::exists( to_fs( tuttrg ) / "data/H0914.hfd" ) )
+				tutver = 2;
+			int exver = 3;
+			if ( fs::exists( to_fs( extrg ) / "data/InitStateGait10.sto" ) )
+				exver = 1;
+			else if ( fs::exists( to_fs( extrg ) / "data/H0914.hfd" ) )
+				exver = 2;
+			hasOldTutorials = tutver != version;
+			hasOldExamples = exver != version;
+		}
+
+		int version;
+		path srcPath, trgPath, tutsrc, exsrc, tuttrg, extrg, pysrc, pytrg;
+		bool hasOldTutorials, hasOldExamples;
+	};
+
+	bool checkTutorialsExamples()
+	{
+		try
+		{
+			TutorialsExamplesFolders f;
+			if ( f.hasOldTutorials || f.hasOldExamples )
+				return true;
+			return !compareFolders( to_qt( f.tutsrc ), to_qt( f.tuttrg ) ).good()
+				|| !compareFolders( to_qt( f.exsrc ), to_qt( f.extrg ) ).good()
+				|| !compareFolders( to_qt( f.pysrc ), to_qt( f.pytrg ) ).good();
+		}
+		catch ( const std::exception& e )
+		{
+			log::warning( "Could not check Tutorials and Examples: ", e.what() );
+			return false;
+		}
+	}
+
 	void updateTutorialsExamples()
 	{
-		int version = GetStudioSetting<int>( "ui.tutorials_version" );
-		auto srcPath = scone::GetFolder( scone::SconeFolder::Root ) / "scenarios";
-		auto trgPath = scone::GetFolder( scone::SconeFolder::Scenarios );
-		auto tutsrc = srcPath / xo::stringf( "Tutorials%d", version );
-		auto exsrc = srcPath / xo::stringf( "Examples%d", version );
-		auto tuttrg = trgPath / "Tutorials";
-		auto extrg = trgPath / "Examples";
-		auto pysrc = srcPath / "SconePy";
-		auto pytrg = trgPath / "SconePy";
-
-		// check which version is installed
-		int tutver = 3;
-		if ( fs::exists( to_fs( tuttrg ) / "Tutorial 1 - Introduction.scone" ) )
-			tutver = 1;
-		else if ( fs::exists( to_fs( tuttrg ) / "data/H0914.hfd" ) )
-			tutver = 2;
-		int exver = 3;
-		if ( fs::exists( to_fs( extrg ) / "data/InitStateGait10.sto" ) )
-			exver = 1;
-		else if ( fs::exists( to_fs( extrg ) / "data/H0914.hfd" ) )
-			exver = 2;
-
-		bool hasOldTutorials = tutver != version;
-		bool hasOldExamples = exver != version;
+		TutorialsExamplesFolders f;
 		bool keepOld = false;
 
 		try
 		{
-			if ( hasOldTutorials || hasOldExamples )
+			if ( f.hasOldTutorials || f.hasOldExamples )
 			{
 				QString msg = QString( "A new version of the SCONE Tutorials and Examples will be installed. Existing files will be moved to:\n" );
 				path tutbackup, exbackup;
-				if ( hasOldTutorials ) {
-					tutbackup = xo::find_unique_directory( tuttrg + "Backup" );
+				if ( f.hasOldTutorials ) {
+					tutbackup = xo::find_unique_directory( f.tuttrg + "Backup" );
 					msg += "\n" + to_qt( tutbackup );
 				}
-				if ( hasOldExamples ) {
-					exbackup = xo::find_unique_directory( extrg + "Backup" );
+				if ( f.hasOldExamples ) {
+					exbackup = xo::find_unique_directory( f.extrg + "Backup" );
 					msg += "\n" + to_qt( exbackup );
 				}
 				if ( QMessageBox::question( nullptr, "Install Tutorials and Examples", msg, QMessageBox::Ok, QMessageBox::Cancel ) == QMessageBox::Ok ) {
-					if ( hasOldTutorials ) fs::rename( to_fs( tuttrg ), to_fs( tutbackup ) );
-					if ( hasOldExamples ) fs::rename( to_fs( extrg ), to_fs( exbackup ) );
+					if ( f.hasOldTutorials ) fs::rename( to_fs( f.tuttrg ), to_fs( tutbackup ) );
+					if ( f.hasOldExamples ) fs::rename( to_fs( f.extrg ), to_fs( exbackup ) );
 				}
 				else keepOld = true;
 			}
@@ -153,9 +312,9 @@ namespace scone
 			// check updates
 			if ( !keepOld )
 			{
-				auto tutCheck = compareFolders( to_qt( tutsrc ), to_qt( tuttrg ) );
-				auto exCheck = compareFolders( to_qt( exsrc ), to_qt( extrg ) );
-				auto pyCheck = compareFolders( to_qt( pysrc ), to_qt( pytrg ) );
+				auto tutCheck = compareFolders( to_qt( f.tutsrc ), to_qt( f.tuttrg ) );
+				auto exCheck = compareFolders( to_qt( f.exsrc ), to_qt( f.extrg ) );
+				auto pyCheck = compareFolders( to_qt( f.pysrc ), to_qt( f.pytrg ) );
 				if ( !tutCheck.good() || !exCheck.good() || !pyCheck.good() )
 				{
 					auto different = tutCheck.different + exCheck.different + pyCheck.different;
@@ -164,9 +323,9 @@ namespace scone
 
 					log::info( "Updating SCONE Tutorials and Examples" );
 					auto options = fs::copy_options::overwrite_existing | fs::copy_options::recursive;
-					fs::copy( to_fs( tutsrc ), to_fs( tuttrg ), options );
-					fs::copy( to_fs( exsrc ), to_fs( extrg ), options );
-					fs::copy( to_fs( pysrc ), to_fs( pytrg ), options );
+					fs::copy( to_fs( f.tutsrc ), to_fs( f.tuttrg ), options );
+					fs::copy( to_fs( f.exsrc ), to_fs( f.extrg ), options );
+					fs::copy( to_fs( f.pysrc ), to_fs( f.pytrg ), options );
 				}
 				else log::info( "SCONE Tutorials and Examples are up-to-date" );
 			}
@@ -174,8 +333,8 @@ namespace scone
 		catch ( const std::exception& e )
 		{
 			QString msg = e.what();
-			msg += ( "\n\nSource=" + srcPath ).c_str();
-			msg += ( "\nTarget=" + trgPath ).c_str();
+			msg += ( "\n\nSource=" + f.srcPath ).c_str();
+			msg += ( "\nTarget=" + f.trgPath ).c_str();
 			QMessageBox::critical( nullptr, "Error updating Tutorials and Examples", msg );
 		}
 	}
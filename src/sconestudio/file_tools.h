@@ -7,8 +7,13 @@
 
 namespace scone
 {
+	class ResultsIndex;
+
 	std::pair<int, double> extractGenBestFromParFile( const QFileInfo& parFile );
+
+	/// Find the .par file with the highest generation, using the summary in the results index when it is up-to-date
 	QFileInfo findBestPar( const QDir& dir );
+	QFileInfo findBestPar( const QDir& dir, ResultsIndex& index );
 
 	bool moveToTrash( const QString& path );
 	bool moveFilesToTrash( const QStringList& files );
@@ -25,6 +30,9 @@ namespace scone
 	CompareFoldersResult compareFolders( const QString& source, const QString& target );
 
 	bool okToUpdateFiles( QStringList l );
+
+	/// Check if tutorials and examples need to be installed or updated; does not use the GUI and is safe to run in a background thread
+	bool checkTutorialsExamples();
 	void updateTutorialsExamples();
 
 	void createSconeModelFile( const QString& sconeFile, const QString& modelFile );
@@ -0,0 +1,320 @@
+/*
+** headless.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#include "headless.h"
+
+#include <QStringList>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <algorithm>
+#include <iostream>
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+#include "scone/core/Benchmark.h"
+#include "scone/core/StorageIo.h"
+#include "scone/core/system_tools.h"
+#include "scone/core/profiler_config.h"
+#include "scone/model/Dof.h"
+#include "scone/optimization/ModelObjective.h"
+#include "scone/optimization/opt_tools.h"
+#include "xo/time/timer.h"
+#include "BatchEvaluation.h"
+#include "BenchmarkSuite.h"
+#include "BatchVideoExport.h"
+#include "xo/serialization/serialize.h"
+#include "GaitAnalysis.h"
+#include "MuscleAnalysis.h"
+#include "StudioSettings.h"
+#include "TraceRecorder.h"
+#include "qt_convert.h"
+
+namespace scone
+{
+	const char* headless_usage =
+		"Usage: sconestudio --headless <command> <arguments>\n\n"
+		"Commands:\n"
+		"  evaluate <file>...       Evaluate .scone or .par files in parallel, print a summary table\n"
+		"  performance <file>       Evaluate a .scone or .par file without storing data, print timing;\n"
+		"                           the profiler results are written to stderr\n"
+		"  benchmark <file>         Benchmark a .scone or .par file, same as Performance Test (Write Stats)\n"
+		"  trace <file> <output>    Evaluate a .scone or .par file per 1/60s frame, write a Chrome trace JSON file;\n"
+		"                           model profiler totals are added to the trace after each frame and written to stderr\n"
+		"  gait <file.sto>...       Run a gait analysis on .sto files, print stride statistics\n"
+		"  muscle <file> [dof]...   Run a muscle analysis sweep for the given or all coordinates;\n"
+		"                           results are written to <file>.<dof>.muscle_analysis.txt\n"
+		"  benchmark-suite <folder> [options]\n"
+		"                           Benchmark all scenarios in a folder, write results to <output>.json and <output>.csv\n"
+		"      --samples <n>        Number of measured evaluations per scenario (default 10)\n"
+		"      --warmup <n>         Number of evaluations before measuring (default 2)\n"
+		"      --threads <n>        Number of concurrent evaluations (default hardware)\n"
+		"      --output <file>      Output file without extension (default <folder>/benchmark_<date>)\n"
+		"      --baseline <file>    JSON file from a previous run; exit code is 3 on regressions\n"
+		"      --threshold <value>  Relative real-time factor drop that is a regression (default 0.05)\n"
+		"  video <file>... [options]\n"
+		"                           Render videos for .par, .scone or .sto files offscreen, print render times\n"
+		"      --preset <file>      Camera and view preset, e.g. distance, yaw, pitch, orbit_speed, follow_body\n"
+		"      --output <folder>    Output folder for the videos (default is the folder of each file)\n"
+		"      --jobs <n>           Number of videos rendered concurrently (default 2)\n"
+		"      --threads <n>        Total number of render threads (default hardware)\n";
+
+	void WriteStorage( QTextStream& str, const Storage<>& sto, const char* time_label )
+	{
+		str << time_label;
+		for ( const auto& label : sto.GetLabels() )
+			str << '\t' << to_qt( label );
+		str << '\n';
+		for ( size_t i = 0; i < sto.GetFrameCount(); ++i ) {
+			const auto& f = sto.GetFrame( i );
+			str << f.GetTime();
+			for ( size_t c = 0; c < sto.GetChannelCount(); ++c )
+				str << '\t' << f[ c ];
+			str << '\n';
+		}
+	}
+
+	// profiler results are written to stderr, because only warnings and errors are logged in headless mode
+	void WriteProfilerResults( Model& model )
+	{
+		if ( model.GetProfiler().enabled() )
+			std::cerr << model.GetProfiler().report() << '\n';
+	}
+
+	int HeadlessEvaluate( const QStringList& files, QTextStream& out )
+	{
+		BatchEvaluation batch( files, GetStudioSetting<bool>( "file.background_evaluation_store_data" ) );
+		batch.start();
+		batch.wait();
+		batch.writeSummary( out );
+		for ( const auto& r : batch.results() )
+			if ( !r.error.empty() )
+				return 1;
+		return 0;
+	}
+
+	int HeadlessPerformance( const QString& file, QTextStream& out )
+	{
+		// same as Performance Test in the GUI, including the profiler results
+		auto profiler_previously_enabled = SetProfilerEnabled( true );
+		auto [optimizer, model] = CreateOptimizerAndModel( path_from_qt( file ) );
+		auto& mo = dynamic_cast<ModelObjective&>( optimizer->GetObjective() );
+		xo::timer real_time;
+		model->SetStoreData( false );
+		mo.AdvanceSimulationTo( *model, model->GetSimulationEndTime() );
+		auto real_dur = real_time().secondsd();
+		auto sim_time = model->GetTime();
+		SetProfilerEnabled( profiler_previously_enabled );
+		WriteProfilerResults( *model );
+		if ( auto sim_report = model->GetSimulationReport(); !sim_report.empty() )
+			std::cerr << sim_report.front().second << '\n';
+		out << "file\tfitness\tsim_time\treal_time\trealtime_factor\n";
+		out << file << '\t' << mo.GetResult( *model ) << '\t' << sim_time << '\t' << real_dur << '\t' << sim_time / real_dur << '\n';
+		return 0;
+	}
+
+	int HeadlessTrace( const QString& file, const QString& output, QTextStream& out )
+	{
+		auto profiler_previously_enabled = SetProfilerEnabled( true );
+		auto [optimizer, model] = CreateOptimizerAndModel( path_from_qt( file ) );
+		auto& mo = dynamic_cast<ModelObjective&>( optimizer->GetObjective() );
+		model->SetStoreData( false );
+
+		// the simulation is advanced per frame, like in the viewer, so that slow frames stand out
+		const TimeInSeconds frame_step = 1.0 / 60;
+		auto end_time = model->GetSimulationEndTime();
+		auto& recorder = GetTraceRecorder();
+		recorder.setEnabled( true );
+		for ( TimeInSeconds t = 0.0; t < end_time && !model->HasSimulationEnded(); )
+		{
+			STUDIO_TRACE_SCOPE( "simulation", "AdvanceSimulationTo" );
+			t = std::min( t + frame_step, end_time );
+			mo.AdvanceSimulationTo( *model, t );
+			recorder.recordSnapshot( "ModelProfiler", "model", model->GetProfiler().report() );
+		}
+		recorder.setEnabled( false );
+		SetProfilerEnabled( profiler_previously_enabled );
+
+		WriteProfilerResults( *model );
+		SCONE_ERROR_IF( !recorder.writeChromeTrace( path_from_qt( output ) ), "Could not write " + output.toStdString() );
+		out << "file\tsim_time\tevents\ttrace_file\n";
+		out << file << '\t' << model->GetTime() << '\t' << recorder.eventCount() << '\t' << output << '\n';
+		return 0;
+	}
+
+	int HeadlessBenchmark( const QString& file )
+	{
+		auto file_path = path_from_qt( file );
+		std::vector<path> included_files;
+		auto scenario_pn = LoadScenario( file_path, &included_files );
+		scone::BenchmarkOptions bopt;
+		bopt.min_samples = 4;
+		bopt.max_samples_factor = 5;
+		scone::BenchmarkScenario( scenario_pn, file_path, bopt );
+		return 0;
+	}
+
+	int HeadlessGaitAnalysis( const QStringList& files, QTextStream& out )
+	{
+		int result = 0;
+		out << "file\tsteps\tstride_length\tstride_time\tspeed\n";
+		for ( const auto& file : files )
+		{
+			Storage<> sto;
+			ReadStorage( sto, path_from_qt( file ) );
+			auto s = ExtractGaitSummary( sto );
+			if ( s.cycles.empty() ) {
+				log::error( "Could not extract enough gait cycles from ", file.toStdString() );
+				result = 1;
+			}
+			out << file << '\t' << s.cycles.size() << '\t' << s.stride_length << '\t' << s.stride_time << '\t' << s.speed << '\n';
+		}
+		return result;
+	}
+
+	int HeadlessMuscleAnalysis( const QString& file, QStringList dofs, QTextStream& out )
+	{
+		auto [optimizer, model] = CreateOptimizerAndModel( path_from_qt( file ) );
+		if ( dofs.empty() )
+			for ( auto* d : model->GetDofs() )
+				if ( d->GetJoint() )
+					dofs.push_back( to_qt( d->GetName() ) );
+
+		auto muscle_detail = GetStudioSetting<bool>( "muscle_analysis.muscle_detail" );
+		auto ligament_detail = GetStudioSetting<bool>( "muscle_analysis.ligament_detail" );
+		auto original_state = model->GetState();
+		out << "dof\tfile\n";
+		for ( const auto& dof_name : dofs )
+		{
+			auto* dof = FindByName( model->GetDofs(), dof_name.toStdString() );
+			Storage<> sto;
+			ComputeMuscleAnalysis( *model, *dof, sto, muscle_detail, ligament_detail );
+			model->SetState( original_state, 0.0 );
+			model->InitStateFromDofs();
+
+			QFileInfo fi( file );
+			QFile result_file( fi.dir().filePath( fi.completeBaseName() + "." + dof_name + ".muscle_analysis.txt" ) );
+			SCONE_ERROR_IF( !result_file.open( QIODevice::WriteOnly | QIODevice::Text ), "Could not write " + result_file.fileName().toStdString() );
+			QTextStream str( &result_file );
+			WriteStorage( str, sto, "angle" );
+			out << dof_name << '\t' << result_file.fileName() << '\n';
+		}
+		return 0;
+	}
+
+	int HeadlessBenchmarkSuite( QStringList args, QTextStream& out )
+	{
+		auto folder = args.takeFirst();
+		BenchmarkSuiteOptions opt;
+		QString output = QDir( folder ).filePath( "benchmark_" + QDateTime::currentDateTime().toString( "yyyyMMdd_hhmmss" ) );
+		QString baseline;
+		while ( args.size() >= 2 )
+		{
+			auto key = args.takeFirst(), value = args.takeFirst();
+			if ( key == "--samples" ) opt.samples = value.toInt();
+			else if ( key == "--warmup" ) opt.warmup = std::max( 0, value.toInt() );
+			else if ( key == "--threads" ) opt.threads = std::max( 0, value.toInt() );
+			else if ( key == "--output" ) output = value;
+			else if ( key == "--baseline" ) baseline = value;
+			else if ( key == "--threshold" ) opt.regression_threshold = value.toDouble();
+			else SCONE_ERROR( "Unknown option: " + key.toStdString() );
+		}
+		SCONE_ERROR_IF( !args.empty(), "Missing value for option " + args.front().toStdString() );
+		SCONE_ERROR_IF( opt.samples < 1, "Invalid value for --samples, must be at least 1" );
+
+		auto results = RunBenchmarkSuite( folder, opt );
+		SCONE_ERROR_IF( !WriteBenchmarkJson( results, output + ".json" ), "Could not write " + output.toStdString() + ".json" );
+		SCONE_ERROR_IF( !WriteBenchmarkCsv( results, output + ".csv" ), "Could not write " + output.toStdString() + ".csv" );
+		out << "scenario\trealtime_factor\tevaluations_per_second\tmedian\tstddev\trejected\terror\n";
+		for ( const auto& r : results )
+			out << r.scenario << '\t' << r.realtime_factor << '\t' << r.evaluations_per_second << '\t'
+			<< r.median << '\t' << r.stddev << '\t' << r.rejected << '\t' << r.error << '\n';
+
+		if ( !baseline.isEmpty() ) {
+			auto regressions = FindBenchmarkRegressions( results, baseline, opt.regression_threshold );
+			for ( const auto& msg : regressions )
+				log::error( "Regression: ", msg.toStdString() );
+			if ( !regressions.empty() )
+				return 3;
+		}
+		return std::any_of( results.begin(), results.end(), []( const BenchmarkResult& r ) { return !r.error.isEmpty(); } ) ? 1 : 0;
+	}
+
+	int HeadlessVideo( QStringList args, QTextStream& out )
+	{
+		QStringList files;
+		PropNode preset_pn;
+		QString output;
+		int jobs = 2, threads = 0;
+		while ( !args.empty() )
+		{
+			auto arg = args.takeFirst();
+			if ( !arg.startsWith( "--" ) ) {
+				files.push_back( arg );
+				continue;
+			}
+			SCONE_ERROR_IF( args.empty(), "Missing value for option " + arg.toStdString() );
+			auto value = args.takeFirst();
+			if ( arg == "--preset" ) preset_pn = xo::load_file( path_from_qt( value ) );
+			else if ( arg == "--output" ) output = value;
+			else if ( arg == "--jobs" ) jobs = std::max( 1, value.toInt() );
+			else if ( arg == "--threads" ) threads = std::max( 0, value.toInt() );
+			else SCONE_ERROR( "Unknown option: " + arg.toStdString() );
+		}
+		SCONE_ERROR_IF( files.empty(), "No files specified" );
+
+		BatchVideoExport batch( files, MakeVideoPreset( preset_pn ), output, jobs, threads );
+		batch.wait();
+		batch.writeSummary( out );
+		for ( const auto& r : batch.results() )
+			if ( !r.error.isEmpty() )
+				return 1;
+		return 0;
+	}
+
+	int RunHeadless( int argc, char* argv[] )
+	{
+		QTextStream out( stdout );
+		QStringList args;
+		for ( int i = 2; i < argc; ++i )
+			args.push_back( QString::fromLocal8Bit( argv[ i ] ) );
+		auto command = args.empty() ? QString() : args.takeFirst();
+
+		try
+		{
+			if ( command == "evaluate" && !args.empty() )
+				return HeadlessEvaluate( args, out );
+			else if ( command == "performance" && args.size() == 1 )
+				return HeadlessPerformance( args.front(), out );
+			else if ( command == "benchmark" && args.size() == 1 )
+				return HeadlessBenchmark( args.front() );
+			else if ( command == "trace" && args.size() == 2 )
+				return HeadlessTrace( args[ 0 ], args[ 1 ], out );
+			else if ( command == "gait" && !args.empty() )
+				return HeadlessGaitAnalysis( args, out );
+			else if ( command == "benchmark-suite" && !args.empty() )
+				return HeadlessBenchmarkSuite( args, out );
+			else if ( command == "video" && !args.empty() )
+				return HeadlessVideo( args, out );
+			else if ( command == "muscle" && !args.empty() ) {
+				auto file = args.takeFirst();
+				return HeadlessMuscleAnalysis( file, args, out );
+			}
+			else {
+				QTextStream( stderr ) << headless_usage;
+				return 2;
+			}
+		}
+		catch ( const std::exception& e )
+		{
+			log::error( e.what() );
+			return 1;
+		}
+	}
+}
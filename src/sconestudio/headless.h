@@ -0,0 +1,16 @@
+/*
+** headless.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+namespace scone
+{
+	/// Run sconestudio --headless <command> <args>, without creating any widgets.
+	/// Results are written to stdout as tab-separated values, returns the process exit code.
+	int RunHeadless( int argc, char* argv[] );
+}
@@ -11,11 +11,11 @@
 
 namespace scone
 {
-	QUrl GetHelpUrl( const QString& keyword )
+	static const xo::flat_map<QString, QString>& GetHelpKeywords()
 	{
-		static xo::flat_map<QString, QString> data;
-		if ( data.empty() )
-		{
+		// initialization of function statics is thread-safe
+		static const xo::flat_map<QString, QString> data = []() {
+			xo::flat_map<QString, QString> data;
 			auto vec = xo::split_str( xo::load_string( GetSconeStudioFolder() / "resources/help/keywords.txt" ), "\n" );
 			for ( const auto& k : vec )
 			{
@@ -23,8 +23,19 @@ namespace scone
 				QString keyword = QString( doku ).remove( '_' );
 				data[keyword] = doku;
 			}
-		}
+			return data;
+		}();
+		return data;
+	}
 
+	void LoadHelpKeywords()
+	{
+		GetHelpKeywords();
+	}
+
+	QUrl GetHelpUrl( const QString& keyword )
+	{
+		const auto& data = GetHelpKeywords();
 		if ( !keyword.isEmpty() )
 		{
 			auto k = keyword.toLower();
@@ -7,6 +7,7 @@
 namespace scone
 {
 	QUrl GetHelpUrl( const QString& keyword );
+	void LoadHelpKeywords(); // can be called from any thread to avoid loading on first use
 	inline QUrl GetWebsiteUrl() { return QUrl( "https://scone.software" ); }
 	inline QUrl GetDownloadUrl() { return QUrl( "https://simtk.org/frs/?group_id=1180" ); }
 	inline QUrl GetForumUrl() { return QUrl( "https://simtk.org/plugins/phpBB/indexPhpbb.php?group_id=1180&pluginname=phpBB" ); }
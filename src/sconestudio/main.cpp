@@ -31,10 +31,24 @@
 #include "StudioSettings.h"
 #include "QSafeApplication.h"
 #include "scone/core/profiler_config.h"
+#include "headless.h"
+#include "help_tools.h"
+#include "AsyncLogSink.h"
 #include <clocale>
+#include <cstring>
 
 int main( int argc, char* argv[] )
 {
+	// headless mode, skips all widget creation
+	if ( argc >= 2 && std::strcmp( argv[1], "--headless" ) == 0 )
+	{
+		QCoreApplication app( argc, argv );
+		std::setlocale( LC_ALL, "C" );
+		xo::log::console_sink console_log_sink( xo::log::level::warning );
+		scone::Initialize();
+		return scone::RunHeadless( argc, argv );
+	}
+
 	// Qt setup, required before creating QApplication
 	QCoreApplication::setAttribute( Qt::AA_UseDesktopOpenGL );
 	QApplication::setStyle( "fusion" );
@@ -58,9 +72,16 @@ int main( int argc, char* argv[] )
 		xo::path log_file = scone::GetSettingsFolder() / "log" / xo::path( xo::get_date_time_str( "%Y%m%d_%H%M%S" ) + ".log" );
 		xo::log::file_sink file_sink( log_file, xo::log::level::debug, xo::log::sink_mode::current_thread );
 		SCONE_THROW_IF( !file_sink.file_stream().good(), "Could not create file " + log_file.str() );
+		xo::log::remove_sink( &file_sink ); // messages are written by the async sink
+		scone::AsyncLogSink async_file_sink( file_sink, xo::log::level::debug, true );
 		xo::log::debug( "Created log file: ", log_file );
 		scone::TimeSection( "InitLog" );
 
+		// startup work that does not depend on widgets runs concurrently with loading the splash screen
+		// this is done after the locale and log sinks are set, because these are not thread-safe
+		auto load_settings = scone::StartStartupTask( "LoadSettings", []() { scone::GetStudioSettings(); scone::LoadHelpKeywords(); } );
+		auto init_scone = scone::StartStartupTask( "InitScone", []() { scone::Initialize(); } );
+
 		// init plash screen
 		QPixmap splash_pm( to_qt( scone::GetSconeStudioFolder() / "resources/ui/scone_splash.png" ) );
 		QSplashScreen splash( splash_pm );
@@ -68,15 +89,18 @@ int main( int argc, char* argv[] )
 		app.processEvents();
 		scone::TimeSection( "ShowSplash" );
 
+		// the main window reads settings and uses scone factories and folders, which are not thread-safe
+		// wait for background tasks before constructing it, this also rethrows their exceptions
+		load_settings.get();
+		init_scone.get();
+		scone::TimeSection( "WaitForInitScone" );
+
 		// init main window
 		SconeStudio w;
 		w.show();
-		w.init();
 		scone::TimeSection( "ShowSconeStudio" );
-
-		// init scone file format and libraries
-		scone::Initialize();
-		scone::TimeSection( "InitScone" );
+		w.init();
+		scone::TimeSection( "InitSconeStudio" );
 
 #if SCONE_HYFYDY_ENABLED
 		// check if license agreement has been updated
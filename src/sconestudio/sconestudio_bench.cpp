@@ -0,0 +1,286 @@
+/*
+** sconestudio_bench.cpp
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+// Micro-benchmarks for studio hot paths, without showing the GUI.
+// Usage: sconestudio_bench [file.scone|file.par]...
+// Without arguments, the first example scenario that comes with SCONE is used.
+
+#include <QApplication>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <atomic>
+#include <clocale>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+#ifdef _WIN32
+#	include <windows.h>
+#	include <psapi.h>
+#else
+#	include <sys/resource.h>
+#endif
+
+#include "scone/core/system_tools.h"
+#include "scone/core/Log.h"
+#include "scone/core/Exception.h"
+#include "scone/model/Dof.h"
+#include "xo/system/log_sink.h"
+#include "xo/time/timer.h"
+#include "xo/serialization/serialize.h"
+#include "xo/string/string_tools.h"
+#include "vis/scene.h"
+
+#include "StudioModel.h"
+#include "ModelVis.h"
+#include "SconeStorageDataModel.h"
+#include "GaitAnalysis.h"
+#include "GaitPlot.h"
+#include "MuscleAnalysis.h"
+#include "ResultsIndex.h"
+#include "StudioSettings.h"
+#include "file_tools.h"
+#include "qt_convert.h"
+
+// count heap allocations of the entire process, only used to compute allocations / op
+static std::atomic<size_t> g_allocation_count{ 0 };
+
+void* operator new( std::size_t size )
+{
+	++g_allocation_count;
+	if ( void* p = std::malloc( size ? size : 1 ) )
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size ) { return operator new( size ); }
+void operator delete( void* p ) noexcept { std::free( p ); }
+void operator delete[]( void* p ) noexcept { std::free( p ); }
+void operator delete( void* p, std::size_t ) noexcept { std::free( p ); }
+void operator delete[]( void* p, std::size_t ) noexcept { std::free( p ); }
+
+namespace scone
+{
+	QTextStream bench_out( stdout );
+
+	// results are written here, so that the compiler cannot optimize away benchmarked calls
+	volatile int bench_sink = 0;
+
+	double getPeakMemoryMB()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS pmc;
+		if ( GetProcessMemoryInfo( GetCurrentProcess(), &pmc, sizeof( pmc ) ) )
+			return pmc.PeakWorkingSetSize / ( 1024.0 * 1024.0 );
+		return 0.0;
+#else
+		rusage ru;
+		if ( getrusage( RUSAGE_SELF, &ru ) != 0 )
+			return 0.0;
+#	ifdef __APPLE__
+		return ru.ru_maxrss / ( 1024.0 * 1024.0 ); // bytes
+#	else
+		return ru.ru_maxrss / 1024.0; // kilobytes
+#	endif
+#endif
+	}
+
+	/// Run f for a fixed number of iterations and print ns/op, allocations/op and the memory high-water mark
+	template< typename F > void Measure( const char* name, int iterations, F f )
+	{
+		f( 0 ); // warm-up, not measured
+		auto allocations = g_allocation_count.load();
+		xo::timer t;
+		for ( int i = 0; i < iterations; ++i )
+			f( i );
+		auto duration = t().secondsd();
+		allocations = g_allocation_count.load() - allocations;
+		bench_out << name << '\t' << iterations << '\t' << 1e9 * duration / iterations << '\t'
+			<< double( allocations ) / iterations << '\t' << getPeakMemoryMB() << '\n';
+		bench_out.flush();
+	}
+
+	Storage<> MakeSyntheticStorage( int channels, int frames, double dt )
+	{
+		Storage<> sto;
+		for ( int c = 0; c < channels; ++c )
+			sto.AddChannel( "channel_" + to_str( c ) );
+		for ( int f = 0; f < frames; ++f ) {
+			auto& frame = sto.AddFrame( f * dt );
+			for ( int c = 0; c < channels; ++c )
+				frame[ c ] = std::sin( f * dt * ( c + 1 ) );
+		}
+		return sto;
+	}
+
+	void BenchStorageDataModel()
+	{
+		const int frames = 10000;
+		const double dt = 0.005;
+		auto sto = MakeSyntheticStorage( 100, frames, dt );
+		SconeStorageDataModel model( &sto );
+
+		// random access and playback access patterns, playback hits the index cache
+		std::mt19937 rng( 123 );
+		std::uniform_real_distribution<double> time_dist( 0.0, frames * dt );
+		std::vector<double> random_times( 1000 );
+		for ( auto& t : random_times )
+			t = time_dist( rng );
+
+		Measure( "SconeStorageDataModel::timeIndex (random)", 100000,
+			[&]( int i ) { bench_sink = model.timeIndex( random_times[ i % random_times.size() ] ); } );
+		Measure( "SconeStorageDataModel::timeIndex (playback)", 100000,
+			[&]( int i ) { bench_sink = model.timeIndex( ( i % frames ) * dt + 0.5 * dt ); } );
+		Measure( "SconeStorageDataModel::getSeries", 1000,
+			[&]( int i ) { bench_sink = int( model.getSeries( i % 100 ).size() ); } );
+		Measure( "SconeStorageDataModel::getSeries (min_interval)", 1000,
+			[&]( int i ) { bench_sink = int( model.getSeries( i % 100, 0.05 ).size() ); } );
+	}
+
+	void BenchScenario( const path& file )
+	{
+		log::info( "Loading ", file );
+		vis::scene scene( true, GetStudioSetting<float>( "viewer.ambient_intensity" ) );
+		StudioModel sm( scene, file, MakeDefaultViewOptions() );
+		SCONE_ERROR_IF( !sm.HasModel(), "Could not create model from " + file.str() );
+
+		// evaluate the full simulation, this creates the data used for playback
+		xo::timer eval_time;
+		sm.EvaluateTo( sm.GetModel().GetSimulationEndTime() );
+		log::info( "Evaluated ", file.filename(), " in ", eval_time().secondsd(), "s" );
+		SCONE_ERROR_IF( !sm.HasData(), "No data after evaluating " + file.str() );
+
+		const auto& sto = sm.GetData();
+		const auto max_time = sm.GetMaxTime();
+		const int frame_count = int( sto.GetFrameCount() );
+		Measure( "StudioModel::UpdateVis", 1000,
+			[&]( int i ) { sm.UpdateVis( max_time * ( i % frame_count ) / frame_count ); } );
+
+		// separate ModelVis, to measure without the state update
+		ModelVis mv( sm.GetModel(), scene, MakeDefaultViewOptions() );
+		Measure( "ModelVis::Update", 1000, [&]( int i ) { mv.Update( sm.GetModel() ); } );
+
+		SconeStorageDataModel data_model( &sto );
+		const int channel_count = int( sto.GetChannelCount() );
+		Measure( "SconeStorageDataModel::getSeries (scenario)", 1000,
+			[&]( int i ) { bench_sink = int( data_model.getSeries( i % channel_count ).size() ); } );
+
+		// gait analysis, only for models that produce gait cycles
+		auto summary = ExtractGaitSummary( sto );
+		if ( !summary.cycles.empty() ) {
+			xo::error_code ec;
+			auto plot_pn = xo::load_file( GetStudioSetting<path>( "gait_analysis.template" ), &ec );
+			std::vector<std::unique_ptr<GaitPlot>> plots;
+			for ( const auto& pn : plot_pn )
+				plots.emplace_back( std::make_unique<GaitPlot>( pn.second ) );
+			Measure( "ExtractGaitSummary", 100, [&]( int i ) { bench_sink = int( ExtractGaitSummary( sto ).cycles.size() ); } );
+			Measure( "GaitPlot::update (all plots)", 100, [&]( int i ) {
+				for ( auto& p : plots )
+					p->update( sto, summary.cycles );
+				} );
+		}
+		else log::warning( "No gait cycles found in ", file.filename(), ", skipping GaitPlot::update" );
+
+		// muscle analysis for the first dof with a joint
+		const auto& dofs = sm.GetModel().GetDofs();
+		auto dof_it = std::find_if( dofs.begin(), dofs.end(), []( const Dof* d ) { return d->GetJoint() != nullptr; } );
+		if ( dof_it != dofs.end() ) {
+			MuscleAnalysis ma( nullptr );
+			ma.init( sm.GetModel() );
+			auto dof_name = to_qt( ( *dof_it )->GetName() );
+			Measure( "MuscleAnalysis::setDof", 20, [&]( int i ) { ma.setDof( sm.GetModel(), dof_name ); } );
+		}
+	}
+
+	void BenchResultsStatus()
+	{
+		// use the result folders of the current user, up to a fixed number
+		QStringList dirs;
+		auto results_folder = to_qt( GetFolder( SconeFolder::Results ) );
+		for ( QDirIterator it( results_folder, QDir::Dirs | QDir::NoDotAndDotDot ); it.hasNext() && dirs.size() < 100; )
+			dirs.push_back( it.next() );
+		if ( dirs.empty() )
+			return log::warning( "No result folders found in ", results_folder.toStdString(), ", skipping results status" );
+
+		// use a temporary index, so that the index of the user is not modified
+		QTemporaryDir temp_dir;
+		SCONE_ERROR_IF( !temp_dir.isValid(), "Could not create temporary folder" );
+		ResultsIndex index( path_from_qt( temp_dir.filePath( "results_index.bin" ) ) );
+
+		// same steps as ResultsFileSystemModel::getStatus, which uses the index and falls back to the indexer
+		std::vector<ResultStatus> stats;
+		for ( const auto& d : dirs )
+			index.insert( d, stats.emplace_back( scanResultFolder( d ) ) );
+		Measure( "ResultsIndex::find + isResultStatusUpToDate", 10000, [&]( int i ) {
+			const auto& d = dirs[ i % dirs.size() ];
+			if ( auto stat = index.find( d ); stat && isResultStatusUpToDate( *stat, QFileInfo( d ) ) )
+				bench_sink = stat->gen;
+			} );
+		Measure( "scanResultFolder", 100, [&]( int i ) { bench_sink = scanResultFolder( dirs[ i % dirs.size() ] ).gen; } );
+		Measure( "findBestPar (up-to-date index)", 100, [&]( int i ) { bench_sink = int( findBestPar( QDir( dirs[ i % dirs.size() ] ), index ).size() ); } );
+
+		// a stale entry falls back to scanning the folder
+		Measure( "findBestPar (stale index)", 100, [&]( int i ) {
+			auto idx = i % dirs.size();
+			auto stale = stats[ idx ];
+			stale.modified = stale.modified.addSecs( -3600 );
+			index.insert( dirs[ idx ], stale );
+			bench_sink = int( findBestPar( QDir( dirs[ idx ] ), index ).size() );
+			} );
+		Measure( "findBestPar (not indexed)", 100, [&]( int i ) {
+			const auto& d = dirs[ i % dirs.size() ];
+			index.remove( d );
+			bench_sink = int( findBestPar( QDir( d ), index ).size() );
+			} );
+	}
+
+	path FindDefaultBenchScenario()
+	{
+		auto examples = to_qt( GetFolder( SconeFolder::Root ) / "scenarios" / xo::stringf( "Examples%d", GetStudioSetting<int>( "ui.tutorials_version" ) ) );
+		QStringList files;
+		for ( QDirIterator it( examples, { "*.scone" }, QDir::Files, QDirIterator::Subdirectories ); it.hasNext(); )
+			files.push_back( it.next() );
+		SCONE_ERROR_IF( files.empty(), "Could not find example scenarios in " + examples.toStdString() );
+		files.sort();
+		return path_from_qt( files.front() );
+	}
+}
+
+int main( int argc, char* argv[] )
+{
+	// widgets are created but never shown
+	if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM" ) )
+		qputenv( "QT_QPA_PLATFORM", "offscreen" );
+	QApplication app( argc, argv );
+	std::setlocale( LC_ALL, "C" );
+	xo::log::console_sink console_log_sink( xo::log::level::info );
+	scone::Initialize();
+
+	try
+	{
+		scone::bench_out << "benchmark\titerations\tns_per_op\tallocations_per_op\tpeak_memory_mb\n";
+		scone::BenchStorageDataModel();
+
+		std::vector<scone::path> files;
+		for ( int i = 1; i < argc; ++i )
+			files.emplace_back( argv[ i ] );
+		if ( files.empty() )
+			files.push_back( scone::FindDefaultBenchScenario() );
+		for ( const auto& f : files )
+			scone::BenchScenario( f );
+
+		scone::BenchResultsStatus();
+		return 0;
+	}
+	catch ( const std::exception& e )
+	{
+		scone::log::error( e.what() );
+		return 1;
+	}
+}
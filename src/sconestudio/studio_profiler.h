@@ -0,0 +1,16 @@
+/*
+** studio_profiler.h
+**
+** Copyright (C) Thomas Geijtenbeek and contributors. All rights reserved.
+**
+** This file is part of SCONE. For more information, see http://scone.software.
+*/
+
+#pragma once
+
+#include "gui_profiler.h"
+#include "TraceRecorder.h"
+
+// scopes are measured by the GUI profiler and recorded as trace events
+#define STUDIO_PROFILE_FUNCTION GUI_PROFILE_FUNCTION; STUDIO_TRACE_FUNCTION( "gui" )
+#define STUDIO_PROFILE_SCOPE( scope_name_arg ) GUI_PROFILE_SCOPE( scope_name_arg ); STUDIO_TRACE_SCOPE( "gui", scope_name_arg )
@@ -3,6 +3,7 @@ file {
 	label = "File"
 	auto_write_scone_evaluation { type = bool label = "Automatically write data after evaluating a .scone file" default = 0 }
 	auto_write_par_evaluation { type = bool label = "Automatically write data after evaluating a .par file" default = 1 }
+	background_evaluation_store_data { type = bool label = "Store and write data when evaluating .par files in the background" default = 1 }
 	playback_start { type = float label = "Time to start playback, negative numbers start from end" default = 0 }
 }
 
@@ -34,6 +35,8 @@ video {
 	quality { type = int default = 2 label = "Quality for video output" }
 	width { type = int default = 1024 label = "Horizontal resolution (only when Viewer is not docked)" }
 	height { type = int default = 768 label = "Vertical resolution (only when Viewer is not docked)" }
+	offscreen_rendering { type = bool default = 1 label = "Render videos of finished results offscreen, using multiple threads" }
+	render_threads { type = int default = 0 label = "Number of threads for offscreen video rendering (0 = number of cores)" }
 }
 
 viewer {
@@ -99,6 +102,10 @@ viewer {
 optimization {
 	label = "Optimization"
 	use_external_process { type = bool default = 0 label = "Perform optimizations using external process" }
+	max_concurrent_optimizations { type = int default = 0 label = "Maximum number of concurrent optimizations when running multiple optimizations (0 = no limit)" range = [ 0 1000 ] }
+	racing_enabled { type = bool default = 0 label = "Stop optimizations of the same scenario when their predicted fitness is dominated by the best optimization" }
+	racing_margin { type = float default = 0.05 label = "Relative margin by which the predicted fitness must be worse than the best fitness" range = [ 0 10 ] }
+	racing_min_generations { type = int default = 200 label = "Minimum number of generations before an optimization can be stopped" range = [ 0 100000 ] }
 }
 
 progress {
@@ -107,6 +114,7 @@ progress {
 	line_width { type = float default = 1 label = "Line width of progress graphs (use 1 for best performance)" range = [ 1 10 ] }
 	show_prediction { type = bool default = 0 label = "Show predicted fitness" }
 	show_fitness_label { type = bool default = 0 label = "Show fitness label on progress graph" }
+	full_resolution_generations { type = int default = 1000 label = "Number of recent generations shown at full resolution (full history is in history.txt)" range = [ 100 100000 ] }
 	max_rows_below_results { type = int default = 3 label = "Maximum number of graph rows below results" }
 	max_columns_below_results { type = int default = 2 label = "Maximum number of graph columns below results" }
 	max_rows_left_of_results { type = int default = 6 label = "Maximum number of graph rows left of results" }
@@ -137,13 +145,14 @@ sconegym {
 	python { type = string label = "Name of the Python executable used for evaluation" default = "python" }
 	num_episodes { type = int label = "Number of episodes to evaluate" default = 5 }
 	max_concurrent_evaluations { type = int label = "Maximum number of concurrent evaluations (0=hardware)" default = 0 }
+	memory_per_evaluation { type = int label = "Expected memory use per evaluation in MB, used to limit concurrent evaluations (0=no limit)" default = 2000 range = [ 0 1000000 ] }
 }
 
 ui {
 	label = "User Interface"
 	log_level { type = int default = 2 label = "Messages log level (1-7)" }
 	evaluation_report_depth { type = int default = 1 label = "Depth to which to expand Evaluation Report tree" }
-	enable_profiler { type = bool default = 0 label = "Enable GUI profiler" }
+	enable_profiler { type = bool default = 0 label = "Enable GUI profiler and trace recording" }
 	show_conversion_support_message { type = bool default = 1 label = "Show support message after convert to Hyfydy" }
 	use_alternative_file_dialog_windows { type = bool default = 0 label = "Use alternative save file dialog windows" }
 	reset_layout { type = bool default = 0 label = "Reset window layout on start" }
@@ -2,10 +2,20 @@
 
 #include "scone/core/system_tools.h"
 #include "scone/core/Exception.h"
+#include "xo/time/timer.h"
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 namespace scone
 {
 	static xo::stopwatch g_StudioStopwatch;
+	static xo::timer g_StartupTimer;
+	static std::vector< std::pair< std::string, double > > g_StartupSections; // name and end time
+	struct StartupTask { std::string name; double start; double end; };
+	static std::vector< StartupTask > g_StartupTasks;
+	static std::mutex g_StartupMutex;
 
 	xo::path GetSconeStudioFolder()
 	{
@@ -18,4 +28,45 @@ namespace scone
 	{
 		return g_StudioStopwatch;
 	}
+
+	void TimeSection( const char* name )
+	{
+		std::scoped_lock lock( g_StartupMutex );
+		g_StudioStopwatch.split( name );
+		g_StartupSections.emplace_back( name, g_StartupTimer().secondsd() );
+	}
+
+	std::future<void> StartStartupTask( const char* name, std::function<void()> task )
+	{
+		return std::async( std::launch::async, [name, task]() {
+			auto start = g_StartupTimer().secondsd();
+			task();
+			std::scoped_lock lock( g_StartupMutex );
+			g_StartupTasks.push_back( { name, start, g_StartupTimer().secondsd() } );
+		} );
+	}
+
+	std::string GetStartupReport()
+	{
+		std::scoped_lock lock( g_StartupMutex );
+		const double total = g_StartupSections.empty() ? 0.0 : g_StartupSections.back().second;
+		std::stringstream str;
+		str << "Startup time breakdown:" << std::fixed;
+		double prev = 0.0;
+		for ( const auto& [name, t] : g_StartupSections ) {
+			str << '\n' << std::left << std::setw( 24 ) << name << std::right
+				<< std::setprecision( 1 ) << std::setw( 9 ) << 1000 * ( t - prev ) << " ms"
+				<< std::setprecision( 0 ) << std::setw( 5 ) << ( total > 0.0 ? 100 * ( t - prev ) / total : 0.0 ) << "%";
+			prev = t;
+		}
+		str << '\n' << std::left << std::setw( 24 ) << "Total" << std::right << std::setprecision( 1 ) << std::setw( 9 ) << 1000 * total << " ms";
+
+		// tasks run concurrently with the sections above, waiting for them is part of a section
+		if ( !g_StartupTasks.empty() )
+			str << "\nBackground tasks:";
+		for ( const auto& t : g_StartupTasks )
+			str << '\n' << std::left << std::setw( 24 ) << t.name << std::right << std::setprecision( 1 )
+				<< std::setw( 9 ) << 1000 * ( t.end - t.start ) << " ms (" << 1000 * t.start << " - " << 1000 * t.end << " ms)";
+		return str.str();
+	}
 }
@@ -2,10 +2,15 @@
 
 #include "xo/filesystem/path.h"
 #include "xo/time/stopwatch.h"
+#include <functional>
+#include <future>
+#include <string>
 
 namespace scone
 {
 	xo::path GetSconeStudioFolder();
 	xo::stopwatch& GetStudioStopwatch();
-	inline void TimeSection( const char* name ) { GetStudioStopwatch().split( name ); }
+	void TimeSection( const char* name );
+	std::future<void> StartStartupTask( const char* name, std::function<void()> task ); // runs in a background thread
+	std::string GetStartupReport(); // duration of each TimeSection since the previous one, and of each startup task
 }